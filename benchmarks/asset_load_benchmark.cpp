@@ -0,0 +1,88 @@
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <filesystem>
+#include <functional>
+#include <vorbis/vorbisfile.h>
+
+#include "sound/platform/desktop/PcmCache.h"
+
+static volatile std::size_t checksum;
+
+/**
+ * The decoding before the cache, a 4KB buffer appended to a vector that grows as it goes
+ */
+static std::size_t growingDecode(const std::string &oggFile) {
+    auto dataSource{std::fopen(oggFile.c_str(), "rb")};
+    if (dataSource == nullptr) throw std::runtime_error("Failed to open file: " + oggFile);
+    OggVorbis_File vorbisFile;
+    if (ov_open_callbacks(dataSource, &vorbisFile, nullptr, 0, OV_CALLBACKS_DEFAULT) < 0) {
+        std::fclose(dataSource);
+        throw std::runtime_error("Failed to open ogg file: " + oggFile);
+    }
+    std::vector<char> decodedSound;
+    char buffer[4096];
+    for (long size; (size = ov_read(&vorbisFile, buffer, 4096, 0, 2, 1, nullptr)) != 0;) {
+        if (size < 0) break;
+        decodedSound.insert(decodedSound.end(), buffer, buffer + size);
+    }
+    ov_clear(&vorbisFile);
+    return decodedSound.size();
+}
+
+/**
+ * Loads every file the given number of times and prints the average time until all of them are ready
+ */
+static void run(const char *name, const std::vector<std::string> &files, unsigned int iterations,
+                const std::function<std::size_t(const std::string &)> &load) {
+    std::size_t bytes{0};
+    auto begin{std::chrono::steady_clock::now()};
+    for (auto i{0u}; i < iterations; ++i) {
+        for (const auto &file: files) bytes += load(file);
+    }
+    auto elapsed{std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin)};
+    std::cout << name << ": " << elapsed.count() / iterations << "ms to ready, " << bytes / iterations
+              << " bytes of samples\n";
+}
+
+/**
+ * Measures the time until the sounds are ready, decoded as before, decoded into a buffer sized up front, and
+ * mapped from the cache
+ * usage: asset-load-benchmark [iterations] <ogg files...>
+ */
+auto main(int argc, char *argv[]) -> int {
+    if (argc < 3) {
+        std::cerr << "usage: asset-load-benchmark [iterations] <ogg files...>\n";
+        return 1;
+    }
+    unsigned int iterations{static_cast<unsigned int>(std::stoul(argv[1]))};
+    std::vector<std::string> files(argv + 2, argv + argc);
+
+    char directoryTemplate[]{"/tmp/asset-load-benchmark-XXXXXX"};
+    if (mkdtemp(directoryTemplate) == nullptr) return 1;
+    std::filesystem::path directory{directoryTemplate};
+
+    run("growing decode  ", files, iterations, growingDecode);
+    run("pre-sized decode", files, iterations, [](const std::string &file) {
+        return PcmCache::decode(file).samples().size();
+    });
+    run("decode and cache", files, 1, [&directory](const std::string &file) {
+        return PcmCache(directory).load(file).samples().size();
+    });
+    PcmCache cache(directory);
+    run("mapped cache    ", files, iterations, [&cache](const std::string &file) {
+        // the samples are touched like alBufferData copies them
+        auto sound{cache.load(file)};
+        std::size_t sum{0};
+        for (auto sample: sound.samples()) sum += static_cast<unsigned char>(sample);
+        checksum = checksum + sum;
+        return sound.samples().size();
+    });
+
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+    return 0;
+}
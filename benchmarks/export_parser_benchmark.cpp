@@ -0,0 +1,68 @@
+#include <ctime>
+#include <chrono>
+#include <string>
+#include <iostream>
+
+#include "TimewExport.h"
+
+/**
+ * Builds an export like `timew export` prints, one 25 minute interval every 30 minutes going back from now
+ */
+static std::string syntheticExport(unsigned int intervals, std::chrono::system_clock::time_point now) {
+    auto timestamp = [](std::chrono::system_clock::time_point time) {
+        auto timeT{std::chrono::system_clock::to_time_t(time)};
+        std::tm utc{};
+        gmtime_r(&timeT, &utc);
+        char buf[32];
+        std::strftime(buf, sizeof(buf), "%Y%m%dT%H%M%SZ", &utc);
+        return std::string(buf);
+    };
+
+    std::string output{"["};
+    for (auto i{intervals}; i > 0; --i) {
+        auto start{now - std::chrono::minutes(30) * i};
+        output.append(i == intervals ? "\n" : ",\n");
+        output.append(R"({"id":)").append(std::to_string(i))
+                .append(R"(,"start":")").append(timestamp(start))
+                .append(R"(","end":")").append(timestamp(start + std::chrono::minutes(25)))
+                .append(R"(","tags":["Write the \"export\" parser","project:pomodoro"],"annotation":"été"})");
+    }
+    output.append("\n]\n");
+    return output;
+}
+
+/**
+ * Measures aggregating a synthetic export fed in the chunk size executeProcess reads from the pipe
+ * usage: export-parser-benchmark [intervals] [iterations]
+ */
+auto main(int argc, char *argv[]) -> int {
+    unsigned int intervals{argc > 1 ? static_cast<unsigned int>(std::stoul(argv[1])) : 100000u};
+    unsigned int iterations{argc > 2 ? static_cast<unsigned int>(std::stoul(argv[2])) : 10u};
+    constexpr std::size_t chunkSize{64 * 1024};
+
+    auto now{std::chrono::system_clock::now()};
+    auto output{syntheticExport(intervals, now)};
+    std::cout << intervals << " intervals, " << output.size() / (1024.0 * 1024.0) << " MiB\n";
+
+    FocusStats stats(now, std::chrono::minutes(25));
+    auto begin{std::chrono::steady_clock::now()};
+    for (auto i{0u}; i < iterations; ++i) {
+        stats = FocusStats(now, std::chrono::minutes(25));
+        unsigned int parsed{0};
+        TimewExport timewExport([&](const TimewExportInterval &interval) {
+            ++parsed;
+            stats.add(interval);
+        });
+        for (std::size_t pos{0}; pos < output.size(); pos += chunkSize)
+            timewExport.feed(std::string_view(output).substr(pos, chunkSize));
+        timewExport.finish();
+        if (parsed != intervals) return 1;
+    }
+    auto elapsed{std::chrono::duration<double>(std::chrono::steady_clock::now() - begin) / iterations};
+
+    std::cout << "parse + aggregate: " << elapsed.count() * 1000 << "ms, "
+              << output.size() / elapsed.count() / (1024 * 1024) << " MiB/s\n"
+              << "today " << stats.todayFocus.count() << "s (" << stats.todayPomodoros << " pomodoros), week "
+              << stats.weekFocus.count() << "s (" << stats.weekPomodoros << " pomodoros)\n";
+    return 0;
+}
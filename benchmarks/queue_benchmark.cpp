@@ -0,0 +1,82 @@
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <string>
+#include <iostream>
+#include <condition_variable>
+
+#include "utils.h"
+
+/**
+ * The mutex and condition variable queue the ring replaced, wait_pop returns by value here
+ */
+template<typename Tp>
+class LockedQueue {
+public:
+    void push(Tp value) {
+        {
+            std::lock_guard lk(m_);
+            c_.push_back(std::move(value));
+        }
+        cv_.notify_one();
+    }
+
+    Tp wait_pop() {
+        std::unique_lock lk(m_);
+        cv_.wait(lk, [&] { return !c_.empty(); });
+        auto value{std::move(c_.front())};
+        c_.pop_front();
+        return value;
+    }
+
+private:
+    std::deque<Tp> c_;
+    std::mutex m_;
+    std::condition_variable cv_;
+};
+
+/**
+ * Pushes from several producers while one consumer pops every element
+ * @return the elements moved per second
+ */
+template<typename Push, typename Pop>
+static double measure(unsigned int producers, unsigned int elements, Push push, Pop pop) {
+    auto begin{std::chrono::steady_clock::now()};
+
+    std::vector<std::thread> threads;
+    for (auto p{0u}; p < producers; ++p) {
+        threads.emplace_back([&, p] {
+            for (auto i{0u}; i < elements; ++i) push(uint64_t{p} << 32 | i);
+        });
+    }
+
+    uint64_t sum{0};
+    for (auto i{0ull}; i < uint64_t{producers} * elements; ++i) sum += pop() & 0xffffffff;
+    for (auto &thread: threads) thread.join();
+
+    auto elapsed{std::chrono::duration<double>(std::chrono::steady_clock::now() - begin)};
+    if (sum != uint64_t{producers} * (uint64_t{elements} * (elements - 1) / 2)) std::cerr << "lost elements\n";
+    return producers * elements / elapsed.count();
+}
+
+/**
+ * Compares the ring with the locked queue it replaced
+ * usage: queue-benchmark [producers] [elements per producer]
+ */
+auto main(int argc, char *argv[]) -> int {
+    unsigned int producers{argc > 1 ? static_cast<unsigned int>(std::stoul(argv[1])) : 4u};
+    unsigned int elements{argc > 2 ? static_cast<unsigned int>(std::stoul(argv[2])) : 1000000u};
+    std::cout << producers << " producers, " << elements << " elements each\n";
+
+    LockedQueue<uint64_t> queue;
+    auto locked{measure(producers, elements, [&](uint64_t value) { queue.push(value); },
+                        [&] { return queue.wait_pop(); })};
+    std::cout << "mutex queue: " << locked / 1e6 << "M elements/s\n";
+
+    utils::concurrent::ring<uint64_t, 1024> ring;
+    auto lockFree{measure(producers, elements, [&](uint64_t value) { ring.push(value); },
+                          [&] { return *ring.wait_pop(); })};
+    std::cout << "ring:        " << lockFree / 1e6 << "M elements/s\n";
+    return 0;
+}
@@ -0,0 +1,59 @@
+#include <chrono>
+#include <algorithm>
+#include <string>
+#include <iostream>
+
+#include "TimewReport.h"
+
+static const std::string report{
+        "Note: '\"Fix the \\\"report\\\" parser\"' is a new tag.\n"
+        "Tracking \"Fix the \\\"report\\\" parser\" project:pomodoro +next\n"
+        "  Started 2022-01-01T10:00:00\n"
+        "  Current                11:30:00\n"
+        "  Total                   1:30:00\n"};
+
+template<typename Function>
+static void run(const char *name, const std::string &output, unsigned int iterations, Function function) {
+    std::size_t checksum{0};
+    auto begin{std::chrono::steady_clock::now()};
+    for (auto i{0u}; i < iterations; ++i) checksum += function(output);
+    auto elapsed{std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin)};
+    std::cout << name << ": " << elapsed.count() / iterations << "ns per call (checksum " << checksum << ")\n";
+}
+
+/**
+ * Measures parsing the report of timew commands
+ * usage: report-parser-benchmark [iterations]
+ */
+auto main(int argc, char *argv[]) -> int {
+    unsigned int iterations{argc > 1 ? static_cast<unsigned int>(std::stoul(argv[1])) : 1000000u};
+
+    auto parse = [](const std::string &output) -> std::size_t {
+        auto parsed{TimewReport::parse(output)};
+        return parsed ? static_cast<std::size_t>(parsed->total.count()) + parsed->tags.size() : 0;
+    };
+    auto tags = [](const std::string &output) -> std::size_t {
+        auto parsed{TimewReport::parse(output)};
+        if (!parsed) return 0;
+        std::size_t count{0};
+        std::string_view tag;
+        for (auto remaining{parsed->tags}; TimewReport::nextTag(remaining, tag);) count += tag.size();
+        return count;
+    };
+    auto description = [](const std::string &output) -> std::size_t {
+        auto parsed{TimewReport::parse(output)};
+        return parsed ? parsed->description().size() : 0;
+    };
+
+    run("parse          ", report, iterations, parse);
+    run("parse + tags   ", report, iterations, tags);
+    run("description    ", report, iterations, description);
+
+    // a report after a megabyte of notes, the parser has to skip the lines before it
+    std::string huge;
+    while (huge.size() < 1024 * 1024) huge.append("Note: 'tag' is a new tag.\n");
+    huge.append(report);
+    run("parse 1MiB     ", huge, std::max(iterations / 10000, 1u), parse);
+
+    return 0;
+}
@@ -0,0 +1,89 @@
+#include <vector>
+#include <chrono>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <unistd.h>
+#include <algorithm>
+#include <sys/wait.h>
+
+#include "utils.h"
+
+/**
+ * The process launcher as it was before posix_spawn, kept as the baseline of the comparison
+ */
+static utils::ProcessResult forkExecuteProcess(const std::string &path, const std::vector<const char *> &args) {
+    int fields[2];  // 0: read fd, 1: write fd
+    char buf[256]{0};
+    auto status{0};
+    std::string output;
+
+    std::vector<char *> argv{const_cast<char *>(path.c_str())};
+    for (auto arg: args) argv.push_back(const_cast<char *>(arg));
+    if (argv.back() != nullptr) argv.push_back(nullptr);
+
+    if (pipe(fields) == -1) throw std::runtime_error("Failed to create pipe");
+    auto pid{fork()};
+
+    switch (pid) {
+        case -1:
+            throw std::runtime_error("Failed to fork");
+        case 0:
+            close(fields[0]);
+            dup2(open("/dev/null", O_RDONLY), STDIN_FILENO);
+            dup2(fields[1], STDOUT_FILENO);
+            dup2(fields[1], STDERR_FILENO);
+            execv(path.c_str(), argv.data());
+            _exit(-1);
+        default:
+            close(fields[1]);
+            waitpid(pid, &status, 0);
+            while (read(fields[0], buf, sizeof(buf)) > 0) { output.append(buf); }
+            close(fields[0]);
+            break;
+    }
+    return {static_cast<uint8_t>(WEXITSTATUS(status)), output};
+}
+
+template<typename Launcher>
+static void run(const char *name, Launcher launcher, const std::string &path, unsigned int iterations) {
+    std::vector<std::chrono::nanoseconds> samples;
+    samples.reserve(iterations);
+
+    for (auto i{0u}; i < iterations; ++i) {
+        auto begin{std::chrono::steady_clock::now()};
+        launcher(path, {nullptr});
+        samples.push_back(std::chrono::steady_clock::now() - begin);
+    }
+
+    std::sort(samples.begin(), samples.end());
+    auto toUs = [](std::chrono::nanoseconds ns) { return std::chrono::duration<double, std::micro>(ns).count(); };
+    std::chrono::nanoseconds total{0};
+    for (auto sample: samples) total += sample;
+
+    std::cout << name << ": mean " << toUs(total / iterations) << "us, p50 " << toUs(samples[iterations / 2])
+              << "us, p99 " << toUs(samples[iterations * 99 / 100]) << "us\n";
+}
+
+/**
+ * Compares the latency of spawning a process with fork() and with posix_spawn
+ * usage: spawn-benchmark [iterations] [resident MiB] [executable]
+ */
+auto main(int argc, char *argv[]) -> int {
+    unsigned int iterations{argc > 1 ? static_cast<unsigned int>(std::stoul(argv[1])) : 1000u};
+    std::size_t residentMiB{argc > 2 ? std::stoul(argv[2]) : 256u};
+    std::string path{argc > 3 ? argv[3] : "/bin/true"};
+    if (iterations == 0) return 1;
+
+    // touch memory so that fork() has page tables to copy, like a process with ncurses and OpenAL loaded
+    std::vector<char> resident(residentMiB * 1024 * 1024);
+    std::memset(resident.data(), 1, resident.size());
+
+    std::cout << "spawning " << path << " " << iterations << " times with " << residentMiB << " MiB resident\n";
+    run("fork + execv", forkExecuteProcess, path, iterations);
+    run("posix_spawn ", [](const std::string &path, const std::vector<const char *> &args) {
+        return utils::executeProcess(path, args);
+    }, path, iterations);
+
+    return resident.empty() ? 0 : resident.back() - 1;
+}
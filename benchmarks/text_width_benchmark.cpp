@@ -0,0 +1,50 @@
+#include <chrono>
+#include <string>
+#include <iostream>
+
+#include "TextWidth.h"
+#include "WrapCache.h"
+
+static const std::string ascii{"Write the quarterly report for the pomodoro project and review the pull requests "
+                               "of the week before the planning meeting +work +writing"};
+static const std::string mixed{"Write the quarterly report \xe4\xb8\xad\xe6\x96\x87 and review the caf\xc3\xa9 notes "
+                               "\xf0\x9f\x8d\x85 before the planning meeting +work +writing"};
+
+template<typename Function>
+static void run(const char *name, const std::string &text, unsigned int iterations, Function function) {
+    std::size_t checksum{0};
+    auto begin{std::chrono::steady_clock::now()};
+    for (auto i{0u}; i < iterations; ++i) checksum += function(text);
+    auto elapsed{std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - begin)};
+    std::cout << name << ": " << elapsed.count() / iterations << "ns per call (checksum " << checksum << ")\n";
+}
+
+/**
+ * Measures the display width and the wrapping of task descriptions
+ * usage: text-width-benchmark [iterations]
+ */
+auto main(int argc, char *argv[]) -> int {
+    unsigned int iterations{argc > 1 ? static_cast<unsigned int>(std::stoul(argv[1])) : 1000000u};
+
+    // decoding every code point is what the width costs without the ASCII fast path
+    auto decoded = [](const std::string &text) -> std::size_t {
+        std::size_t cells{0};
+        for (std::size_t pos{0}; pos < text.size();) cells += utils::text::cellWidth(utils::text::decode(text, pos));
+        return cells;
+    };
+    auto width = [](const std::string &text) -> std::size_t { return utils::text::displayWidth(text); };
+    auto wrap = [](const std::string &text) -> std::size_t {
+        return utils::text::WrapCache<char>::wrap(text, 40).size();
+    };
+    utils::text::WrapCache<char> cache;
+    auto cached = [&cache](const std::string &text) -> std::size_t { return cache.lines(text, 40).size(); };
+
+    run("decoded width (ascii)", ascii, iterations, decoded);
+    run("display width (ascii)", ascii, iterations, width);
+    run("decoded width (mixed)", mixed, iterations, decoded);
+    run("display width (mixed)", mixed, iterations, width);
+    run("wrap (ascii)", ascii, iterations, wrap);
+    run("wrap (mixed)", mixed, iterations, wrap);
+    run("cached wrap (mixed)", mixed, iterations, cached);
+    return 0;
+}
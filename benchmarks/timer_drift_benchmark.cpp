@@ -0,0 +1,81 @@
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <iostream>
+#include <algorithm>
+
+#include "DeadlineTimer.h"
+
+struct DriftResult {
+    std::chrono::nanoseconds drift;         // how much later than planned the session ended
+    std::chrono::nanoseconds maxLateness;   // the latest a single tick was
+};
+
+/**
+ * The count down before the deadline timer, sleeping for a tick minus the error of the previous one
+ */
+static DriftResult relativeSleep(unsigned int ticks, std::chrono::nanoseconds tick) {
+    std::chrono::nanoseconds delta(0), maxLateness(0);
+    auto begin{std::chrono::steady_clock::now()};
+    auto prevTime{begin};
+
+    for (auto i{0u}; i < ticks; ++i) {
+        auto sleepTime{tick - delta};
+        std::this_thread::sleep_for(sleepTime);
+        auto curTime{std::chrono::steady_clock::now()};
+        auto timeSlept{curTime - prevTime};
+        delta = (timeSlept - sleepTime) % tick;
+        maxLateness = std::max(maxLateness, curTime - (begin + tick * (i + 1)));
+        prevTime = curTime;
+    }
+
+    return {std::chrono::steady_clock::now() - begin - tick * ticks, maxLateness};
+}
+
+static DriftResult absoluteDeadline(unsigned int ticks, std::chrono::nanoseconds tick) {
+    DeadlineTimer timer(DeadlineTimer::Clock::MONOTONIC);
+    std::chrono::nanoseconds maxLateness(0);
+    auto begin{timer.now()};
+
+    for (auto i{1u}; i <= ticks; ++i) {
+        timer.waitUntil(begin + tick * i);
+        maxLateness = std::max(maxLateness, timer.now() - (begin + tick * i));
+    }
+
+    return {timer.now() - begin - tick * ticks, maxLateness};
+}
+
+/**
+ * Runs a simulated 25 minute focus session, 1500 ticks, with every core busy and compares how late each timer ends
+ * usage: timer-drift-benchmark [tick milliseconds] [load threads]
+ */
+auto main(int argc, char *argv[]) -> int {
+    constexpr unsigned int ticks{25 * 60};
+    std::chrono::milliseconds tick{argc > 1 ? std::stol(argv[1]) : 10};
+    unsigned int loadThreads{argc > 2 ? static_cast<unsigned int>(std::stoul(argv[2])) :
+                             std::max(std::thread::hardware_concurrency(), 1u)};
+
+    std::atomic<bool> loaded{true};
+    std::vector<std::thread> load;
+    for (auto i{0u}; i < loadThreads; ++i) {
+        load.emplace_back([&] {
+            volatile uint64_t spin{0};
+            while (loaded.load(std::memory_order_relaxed)) spin = spin + 1;
+        });
+    }
+
+    std::cout << ticks << " ticks of " << tick.count() << "ms, " << loadThreads << " busy threads\n";
+    auto print = [](const char *name, const DriftResult &result) {
+        std::cout << name << ": drift " << std::chrono::duration<double, std::milli>(result.drift).count()
+                  << "ms, worst tick " << std::chrono::duration<double, std::milli>(result.maxLateness).count()
+                  << "ms late\n";
+    };
+    print("sleep_for + correction", relativeSleep(ticks, tick));
+    print("absolute deadline     ", absoluteDeadline(ticks, tick));
+
+    loaded.store(false, std::memory_order_relaxed);
+    for (auto &thread: load) thread.join();
+    return 0;
+}
@@ -0,0 +1,136 @@
+#include <chrono>
+#include <random>
+#include <string>
+#include <vector>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <filesystem>
+#include <functional>
+
+#include "utils.h"
+#include "WavReader.h"
+
+using utils::pcm::Encoding;
+
+static volatile std::size_t checksum;
+
+/**
+ * Writes a stereo .wav file of random samples, with the 44 bytes header the loader before the parser expected
+ */
+static void writeWav(const std::filesystem::path &path, Encoding encoding, std::size_t bytes) {
+    auto sampleBytes{static_cast<uint16_t>(utils::pcm::sampleBytes(encoding))};
+    uint16_t channels{2}, formatTag{static_cast<uint16_t>(encoding == Encoding::FLOAT_32 ? 3 : 1)};
+    uint16_t blockAlign{static_cast<uint16_t>(channels * sampleBytes)}, bits{static_cast<uint16_t>(sampleBytes * 8)};
+    uint32_t sampleRate{44100}, byteRate{sampleRate * blockAlign};
+    bytes -= bytes % blockAlign;
+
+    std::vector<char> samples(bytes);
+    std::mt19937 random{42};
+    if (encoding == Encoding::FLOAT_32) {
+        std::uniform_real_distribution<float> distribution(-1.0f, 1.0f);
+        for (std::size_t i{0}; i < bytes; i += 4) {
+            auto value{distribution(random)};
+            std::memcpy(samples.data() + i, &value, 4);
+        }
+    } else {
+        for (auto &sample: samples) sample = static_cast<char>(random());
+    }
+
+    auto put = [](std::ofstream &file, auto value) { file.write(reinterpret_cast<const char *>(&value), sizeof(value)); };
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write("RIFF", 4);
+    put(file, static_cast<uint32_t>(4 + 8 + 16 + 8 + bytes));
+    file.write("WAVEfmt ", 8);
+    put(file, uint32_t{16});
+    put(file, formatTag);
+    put(file, channels);
+    put(file, sampleRate);
+    put(file, byteRate);
+    put(file, blockAlign);
+    put(file, bits);
+    file.write("data", 4);
+    put(file, static_cast<uint32_t>(bytes));
+    file.write(samples.data(), static_cast<std::streamsize>(bytes));
+}
+
+/**
+ * The loading before the parser, a fixed 44 bytes header and the whole file read
+ */
+static std::size_t freadLoad(const std::string &path) {
+    auto file{std::fopen(path.c_str(), "r")};
+    if (file == nullptr) return 0;
+    char header[44];
+    std::fread(header, 1, sizeof(header), file);
+    uint32_t size;
+    std::memcpy(&size, header + 40, sizeof(size));
+    auto buffer{std::make_unique<char[]>(size)};
+    auto read{std::fread(buffer.get(), 1, size, file)};
+    std::fclose(file);
+    return read;
+}
+
+/**
+ * Runs a function the given number of times and prints the throughput of the bytes it went through
+ */
+static void run(const std::string &name, unsigned int iterations, std::size_t bytes,
+                const std::function<std::size_t()> &function) {
+    std::size_t sum{0};
+    auto begin{std::chrono::steady_clock::now()};
+    for (auto i{0u}; i < iterations; ++i) sum += function();
+    auto elapsed{std::chrono::duration<double>(std::chrono::steady_clock::now() - begin)};
+    checksum = checksum + sum;
+    std::cout << name << ": " << elapsed.count() * 1000 / iterations << "ms, "
+              << static_cast<double>(bytes) * iterations / elapsed.count() / (1 << 20) << " MiB/s\n";
+}
+
+/**
+ * Measures loading large .wav files of every encoding, and the sample conversion alone
+ * usage: wav-load-benchmark [iterations] [MiB]
+ */
+auto main(int argc, char *argv[]) -> int {
+    unsigned int iterations{argc > 1 ? static_cast<unsigned int>(std::stoul(argv[1])) : 20u};
+    std::size_t bytes{(argc > 2 ? std::stoul(argv[2]) : 64ul) << 20};
+
+    char directoryTemplate[]{"/tmp/wav-load-benchmark-XXXXXX"};
+    if (mkdtemp(directoryTemplate) == nullptr) return 1;
+    std::filesystem::path directory{directoryTemplate};
+
+    const std::pair<Encoding, const char *> encodings[]{
+            {Encoding::SIGNED_16, "16 bits"}, {Encoding::UNSIGNED_8, "8 bits"}, {Encoding::SIGNED_24, "24 bits"},
+            {Encoding::SIGNED_32, "32 bits"}, {Encoding::FLOAT_32,   "float"}};
+    for (const auto &[encoding, name]: encodings) {
+        auto path{(directory / (std::string(name) + ".wav")).string()};
+        writeWav(path, encoding, bytes);
+        std::string label{name};
+        label.resize(8, ' ');
+
+        if (encoding == Encoding::SIGNED_16) run("fread   " + label, iterations, bytes, [&] { return freadLoad(path); });
+        // the samples are touched like alBufferData copies them
+        run("load    " + label, iterations, bytes, [&] {
+            auto sound{WavReader::load(path)};
+            std::size_t sum{0};
+            for (auto sample: sound.samples()) sum += static_cast<unsigned char>(sample);
+            return sum;
+        });
+        if (encoding == Encoding::SIGNED_16) continue;
+
+        utils::MappedFile file(path);
+        auto samples{WavReader::parse(file.view()).samples};
+        std::vector<int16_t> out(samples.size() / utils::pcm::sampleBytes(encoding));
+        run("scalar  " + label, iterations, samples.size(), [&] {
+            utils::pcm::toSigned16Scalar(encoding, samples, out.data());
+            return static_cast<std::size_t>(out.back());
+        });
+        run("vector  " + label, iterations, samples.size(), [&] {
+            utils::pcm::toSigned16(encoding, samples, out.data());
+            return static_cast<std::size_t>(out.back());
+        });
+    }
+
+    std::error_code error;
+    std::filesystem::remove_all(directory, error);
+    return 0;
+}
@@ -0,0 +1,26 @@
+# Generates the source defining assets::embedded with the bytes of the sounds
+# usage: cmake -DOUTPUT=<source> -DSOUNDS=<file,file...> -P EmbedSounds.cmake, the files in the order of SoundId
+
+string(REPLACE "," ";" SOUNDS "${SOUNDS}")
+set(SOURCE "#include \"sound/Assets.h\"\n\n")
+set(VIEWS "")
+set(INDEX 0)
+foreach (SOUND ${SOUNDS})
+    # a string literal of hex escapes, the fastest to compile
+    file(READ ${SOUND} HEX HEX)
+    string(REGEX REPLACE "([0-9a-f][0-9a-f])" "\\\\x\\1" BYTES "${HEX}")
+    get_filename_component(NAME ${SOUND} NAME)
+    string(APPEND SOURCE "// ${NAME}\nstatic constexpr char sound${INDEX}[]{\"${BYTES}\"};\n\n")
+    string(APPEND VIEWS "            std::string_view(sound${INDEX}, sizeof(sound${INDEX}) - 1),\n")
+    math(EXPR INDEX "${INDEX} + 1")
+endforeach ()
+
+string(APPEND SOURCE "static_assert(${INDEX} == assets::soundCount, \"a sound of SoundId isn't embedded\");\n\n"
+        "std::string_view assets::embedded(SoundId sound) {\n"
+        "    static constexpr std::array<std::string_view, soundCount> sounds{\n${VIEWS}    };\n"
+        "    return sounds[index(sound)];\n}\n")
+
+# rewritten only when it changes, so a new configure doesn't rebuild it
+file(WRITE ${OUTPUT}.tmp "${SOURCE}")
+file(COPY_FILE ${OUTPUT}.tmp ${OUTPUT} ONLY_IF_DIFFERENT)
+file(REMOVE ${OUTPUT}.tmp)
@@ -0,0 +1,34 @@
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+
+#include "TimewReport.h"
+
+/**
+ * Checks that a view points into the parsed input
+ */
+static void checkBounds(std::string_view input, std::string_view view) {
+    if (view.empty()) return;
+    if (view.data() < input.data() || view.data() + view.size() > input.data() + input.size()) std::abort();
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, std::size_t size) {
+    // copied so that reading past the end is caught by the address sanitizer
+    std::string input(reinterpret_cast<const char *>(data), size);
+    std::string_view view{input};
+
+    if (auto report{TimewReport::parse(view)}; report) {
+        checkBounds(view, report->tags);
+        checkBounds(view, report->started);
+        checkBounds(view, report->current);
+        if (report->total.count() < 0) std::abort();
+
+        std::string_view tag;
+        auto tags{report->tags};
+        while (TimewReport::nextTag(tags, tag)) checkBounds(view, tag);
+        if (report->description().size() > report->tags.size()) std::abort();
+    }
+
+    TimewReport::parseDuration(view);
+    return 0;
+}
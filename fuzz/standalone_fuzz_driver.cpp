@@ -0,0 +1,64 @@
+#include <random>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <filesystem>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, std::size_t size);
+
+/**
+ * Runs a fuzz target without libFuzzer (e.g. with gcc), by mutating the seed inputs at random
+ * usage: <fuzzer> [iterations] [corpus directory...]
+ */
+auto main(int argc, char *argv[]) -> int {
+    unsigned long iterations{argc > 1 ? std::stoul(argv[1]) : 100000ul};
+    std::vector<std::string> seeds{""};
+
+    for (auto i{2}; i < argc; ++i) {
+        for (const auto &entry: std::filesystem::directory_iterator(argv[i])) {
+            std::ifstream file(entry.path(), std::ios::binary);
+            std::stringstream content;
+            content << file.rdbuf();
+            seeds.push_back(content.str());
+        }
+    }
+
+    std::mt19937_64 random{std::random_device{}()};
+    auto pick = [&](std::size_t bound) { return bound == 0 ? 0 : std::uniform_int_distribution<std::size_t>(0, bound - 1)(random); };
+    const std::string interesting{"\n \t:\"\\#TrackingTotal0123456789"};
+
+    for (auto i{0ul}; i < iterations; ++i) {
+        auto input{seeds[pick(seeds.size())]};
+        for (auto mutations{pick(8) + 1}; mutations > 0; --mutations) {
+            switch (pick(6)) {
+                case 0:     // truncate, reports that end early used to be read past their end
+                    input.resize(pick(input.size() + 1));
+                    break;
+                case 1:     // flip a byte
+                    if (!input.empty()) input[pick(input.size())] = static_cast<char>(pick(256));
+                    break;
+                case 2:     // insert a character that matters to the parser
+                    input.insert(pick(input.size() + 1), 1, interesting[pick(interesting.size())]);
+                    break;
+                case 3:     // erase a range
+                    if (!input.empty()) {
+                        auto pos{pick(input.size())};
+                        input.erase(pos, pick(input.size() - pos + 1));
+                    }
+                    break;
+                case 4:     // splice another seed in
+                    input.insert(pick(input.size() + 1), seeds[pick(seeds.size())]);
+                    break;
+                default:    // grow, huge outputs
+                    if (input.size() < 4 * 1024 * 1024) input += input;
+                    break;
+            }
+        }
+        LLVMFuzzerTestOneInput(reinterpret_cast<const uint8_t *>(input.data()), input.size());
+    }
+
+    std::cout << iterations << " inputs without a crash\n";
+    return 0;
+}
@@ -0,0 +1,32 @@
+#include <cstdint>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <stdexcept>
+
+#include "utils.h"
+#include "WavReader.h"
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, std::size_t size) {
+    // copied so that reading past the end is caught by the address sanitizer
+    std::string input(reinterpret_cast<const char *>(data), size);
+    std::string_view view{input};
+
+    WavReader::Format format{};
+    try {
+        format = WavReader::parse(view);
+    } catch (const std::runtime_error &) {
+        return 0;
+    }
+    auto samples{format.samples};
+    if (samples.data() < view.data() || samples.data() + samples.size() > view.data() + view.size()) std::abort();
+    if (samples.size() % (format.channels * utils::pcm::sampleBytes(format.encoding)) != 0) std::abort();
+
+    // the vector kernels convert like the scalar one, at any offset and length
+    std::vector<int16_t> vector(samples.size() / utils::pcm::sampleBytes(format.encoding));
+    std::vector<int16_t> scalar(vector.size());
+    utils::pcm::toSigned16(format.encoding, samples, vector.data());
+    utils::pcm::toSigned16Scalar(format.encoding, samples, scalar.data());
+    if (vector != scalar) std::abort();
+    return 0;
+}
@@ -0,0 +1,132 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <cstdint>
+#include <string_view>
+
+#include "Ncurses.h"
+
+namespace utils::glyphs {
+    inline constexpr int baseHeight{5};
+    inline constexpr int maxScaleX{6};
+    inline constexpr int maxScaleY{3};
+
+    /**
+     * A glyph as one bitmask per row, the most significant of the width bits is the leftmost cell
+     */
+    struct Glyph {
+        int width;
+        std::array<uint32_t, baseHeight * maxScaleY> rows;
+    };
+
+    /**
+     * The glyphs of '0' to '9' and ':' at one size
+     */
+    struct Font {
+        int scaleX;
+        int scaleY;
+        int height;
+        int gap;    // the blank cells between two glyphs
+        std::array<Glyph, 11> glyphs;
+    };
+
+    /**
+     * The 3x5 glyphs every size is scaled from
+     */
+    inline constexpr Glyph baseGlyphs[]{
+            {3, {0b111, 0b101, 0b101, 0b101, 0b111}},
+            {3, {0b010, 0b110, 0b010, 0b010, 0b111}},
+            {3, {0b111, 0b001, 0b111, 0b100, 0b111}},
+            {3, {0b111, 0b001, 0b111, 0b001, 0b111}},
+            {3, {0b101, 0b101, 0b111, 0b001, 0b001}},
+            {3, {0b111, 0b100, 0b111, 0b001, 0b111}},
+            {3, {0b111, 0b100, 0b111, 0b101, 0b111}},
+            {3, {0b111, 0b001, 0b001, 0b001, 0b001}},
+            {3, {0b111, 0b101, 0b111, 0b101, 0b111}},
+            {3, {0b111, 0b101, 0b111, 0b001, 0b111}},
+            {1, {0b0, 0b1, 0b0, 0b1, 0b0}}};
+
+    /**
+     * Scales the base glyphs, every cell becomes scaleX by scaleY cells
+     */
+    constexpr Font scale(int scaleX, int scaleY) {
+        Font font{scaleX, scaleY, baseHeight * scaleY, scaleX, {}};
+        for (std::size_t g{0}; g < font.glyphs.size(); ++g) {
+            auto &base{baseGlyphs[g]};
+            auto &glyph{font.glyphs[g]};
+            glyph.width = base.width * scaleX;
+            for (auto row{0}; row < font.height; ++row) {
+                uint32_t bits{0};
+                for (auto col{base.width - 1}; col >= 0; --col) {
+                    auto cell{(base.rows[row / scaleY] >> col) & 1u};
+                    for (auto i{0}; i < scaleX; ++i) bits = bits << 1 | cell;
+                }
+                glyph.rows[row] = bits;
+            }
+        }
+        return font;
+    }
+
+    /**
+     * The sizes of the clock, smallest first, terminal cells are about twice as tall as wide so the glyphs are
+     * scaled twice as much horizontally
+     */
+    inline constexpr Font fonts[]{scale(1, 1), scale(2, 1), scale(4, 2), scale(maxScaleX, maxScaleY)};
+
+    static_assert(fonts[0].glyphs[8].rows[1] == 0b101 && fonts[1].glyphs[10].rows[3] == 0b11 &&
+                  fonts[2].glyphs[0].rows[3] == 0b111100001111, "the glyphs are scaled from the base glyphs");
+
+    /**
+     * Get the glyph of a character
+     * @return the glyph, or nullptr for a character without one
+     */
+    constexpr const Glyph *glyph(const Font &font, char c) {
+        if (c >= '0' && c <= '9') return &font.glyphs[c - '0'];
+        return c == ':' ? &font.glyphs[10] : nullptr;
+    }
+
+    /**
+     * Get the number of cells a text takes at a size
+     */
+    constexpr int width(const Font &font, std::string_view text) {
+        auto cells{0};
+        for (auto c: text) {
+            auto g{glyph(font, c)};
+            cells += (g ? g->width : font.scaleX * 3) + font.gap;
+        }
+        return text.empty() ? 0 : cells - font.gap;
+    }
+}
+
+/**
+ * Draws a clock in big digits on a screen, and on each tick only the glyphs whose character changed
+ */
+class BigClock {
+public:
+    explicit BigClock(const Ncurses::Screen &screen);
+
+    /**
+     * Picks the largest size at which a text of the length of "00:00:00" fits
+     * @param lines the number of lines available
+     * @param cols the number of columns available
+     * @return the number of lines the clock takes, 1 if no size fits and the clock is drawn as plain text
+     */
+    int fit(int lines, int cols);
+
+    /**
+     * Draws a text made of digits and ':' centered with its top at the line y
+     */
+    void draw(const std::string &text, int y);
+
+    /**
+     * Draws the whole clock on the next draw, e.g. after the screen was cleared
+     */
+    void invalidate();
+
+private:
+    const Ncurses::Screen &screen_;
+    const utils::glyphs::Font *font_ = nullptr;     // the text is drawn as is without a size that fits
+    std::string shown_;
+    int shownY_ = -1;
+};
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <optional>
+#include <functional>
+#include <string_view>
+
+#include "EventLoop.h"
+
+/**
+ * The commands accepted on the control socket, one per datagram as its name in lower case
+ */
+enum class ControlCommand {
+    START,      // a session from the tracking started by another tool
+    CONTINUE,   // continues the paused session
+    PAUSE,
+    STATUS,     // replies the status line
+    QUIT
+};
+
+/**
+ * Receives commands as datagrams on a Unix domain socket, so that hooks and scripts drive the running instance
+ * without spawning processes or signaling every instance
+ * @note a client that bound its own address, e.g. autobound, gets a reply, the others only send
+ */
+class ControlSocket {
+public:
+    /**
+     * Called from the event loop with a received command
+     * @return the reply, sent to clients that can receive it
+     */
+    typedef std::function<std::string(ControlCommand)> Handler;
+
+    /**
+     * Get the socket path of the current user, in $XDG_RUNTIME_DIR when it's set
+     */
+    static std::string defaultPath();
+
+    /**
+     * Get the command named by a datagram, surrounding white space is ignored
+     */
+    static std::optional<ControlCommand> parse(std::string_view datagram);
+
+    /**
+     * Sends a command to the socket of a running instance
+     * @param path the socket path
+     * @param command the datagram
+     * @param timeout the time to wait for the reply, zero to send without waiting for one
+     * @return the reply, empty if none was awaited
+     * @throws std::runtime_error if nothing listens on the socket or the reply didn't come in time
+     */
+    static std::string send(const std::string &path, std::string_view command,
+                            std::chrono::milliseconds timeout) noexcept(false);
+
+    /**
+     * Binds the socket, replacing one left by a process that exited
+     * @param loop the event loop the datagrams are read on
+     * @param path the socket path
+     * @param handler called with every valid command
+     * @throws std::runtime_error if the socket can't be bound or another process listens on it
+     */
+    ControlSocket(EventLoop &loop, std::string path, Handler handler) noexcept(false);
+
+    ControlSocket(const ControlSocket &) = delete;
+
+    ControlSocket &operator=(const ControlSocket &) = delete;
+
+    ~ControlSocket();
+
+private:
+    /**
+     * Reads the pending datagrams and replies to each
+     */
+    void read();
+
+    EventLoop &loop_;
+    std::string path_;
+    Handler handler_;
+    int fd_ = -1;
+};
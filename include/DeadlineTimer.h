@@ -0,0 +1,72 @@
+#pragma once
+
+#include <chrono>
+
+/**
+ * Waits for absolute deadlines on a timerfd, so the ticks of a count down never accumulate the lateness of a wakeup
+ * and waiting can be interrupted right away from another thread or a signal handler
+ * @note an event loop can watch fd() instead of waiting
+ */
+class DeadlineTimer {
+public:
+    enum class Clock {
+        MONOTONIC,  // stops while the system is suspended
+        BOOTTIME    // keeps counting while the system is suspended
+    };
+
+    /**
+     * @param clock the clock the deadlines are measured on
+     */
+    explicit DeadlineTimer(Clock clock = Clock::BOOTTIME) noexcept(false);
+
+    DeadlineTimer(const DeadlineTimer &) = delete;
+
+    DeadlineTimer &operator=(const DeadlineTimer &) = delete;
+
+    ~DeadlineTimer();
+
+    /**
+     * Get the current time of the clock of the timer
+     */
+    [[nodiscard]] std::chrono::nanoseconds now() const;
+
+    /**
+     * Get the timerfd, it becomes readable when the armed deadline passes
+     */
+    [[nodiscard]] int fd() const;
+
+    /**
+     * Sets the deadline the timerfd becomes readable at, replacing the previous one
+     * @param deadline the time on the clock of the timer, a deadline that already passed fires right away
+     */
+    void arm(std::chrono::nanoseconds deadline) noexcept(false);
+
+    /**
+     * Cancels the armed deadline
+     */
+    void disarm();
+
+    /**
+     * Consumes the expiration of the armed deadline
+     * @return true if the deadline passed since it was armed
+     */
+    bool expired();
+
+    /**
+     * Waits until a deadline passes or the timer is woken up
+     * @param deadline the time on the clock of the timer to wait for
+     * @return true if the deadline passed, false if the timer was woken up
+     */
+    bool waitUntil(std::chrono::nanoseconds deadline) noexcept(false);
+
+    /**
+     * Interrupts the current wait, or the next one if the timer isn't waiting
+     * @note async-signal-safe
+     */
+    void wake() const;
+
+private:
+    int clockId_;
+    int timerFd_ = -1;
+    int wakeFd_ = -1;
+};
@@ -0,0 +1,103 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <thread>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <initializer_list>
+#include <sys/epoll.h>
+
+#include "utils.h"
+
+/**
+ * A single threaded reactor over epoll, every handler runs on the thread that created the loop, which is the one
+ * that calls run()
+ */
+class EventLoop {
+public:
+    /**
+     * Called with the epoll events of a watched file descriptor
+     */
+    typedef std::function<void(uint32_t events)> Handler;
+
+    EventLoop() noexcept(false);
+
+    EventLoop(const EventLoop &) = delete;
+
+    EventLoop &operator=(const EventLoop &) = delete;
+
+    ~EventLoop();
+
+    /**
+     * Calls a handler whenever a file descriptor is ready
+     * @note the file descriptor must stay open until it's unwatched
+     * @param fd the file descriptor to watch
+     * @param events the epoll events to wait for
+     * @param handler called with the ready events
+     */
+    void watch(int fd, uint32_t events, Handler handler) noexcept(false);
+
+    /**
+     * Stops watching a file descriptor, its handler isn't called anymore even for events already received
+     */
+    void unwatch(int fd);
+
+    /**
+     * Blocks signals on the calling thread
+     * @note call it before starting other threads so that they inherit the mask and the signals only reach the
+     * signalfd of watchSignals
+     */
+    static void blockSignals(std::initializer_list<int> signals) noexcept(false);
+
+    /**
+     * Delivers signals through a signalfd instead of asynchronous handlers
+     * @note the signals are blocked on the calling thread as with blockSignals
+     * @param signals the signals to deliver
+     * @param handler called with the number of each received signal
+     */
+    void watchSignals(std::initializer_list<int> signals, std::function<void(int signal)> handler) noexcept(false);
+
+    /**
+     * Runs a task on the loop after the events of the current iteration
+     * @note thread-safe, other threads wait while 256 of their tasks are queued
+     */
+    void post(std::function<void()> task);
+
+    /**
+     * Calls a hook every time the loop is about to wait for events, once the handlers and posted tasks of an
+     * iteration ran, e.g. to flush what they drew as one frame
+     * @param hook replaces the previous one
+     */
+    void beforeWait(std::function<void()> hook);
+
+    /**
+     * Dispatches events until stop() is called
+     */
+    void run() noexcept(false);
+
+    /**
+     * Makes run() return after the current iteration
+     */
+    void stop();
+
+private:
+    struct Watch {
+        uint32_t generation;
+        std::shared_ptr<Handler> handler;
+    };
+
+    void runPosted();
+
+    int epollFd_ = -1;
+    int wakeFd_ = -1;
+    int signalFd_ = -1;
+    bool running_ = false;
+    uint32_t generation_ = 0;   // tells apart a file descriptor number that was reused after being unwatched
+    std::unordered_map<int, Watch> watches_;
+    std::function<void()> beforeWait_;
+    std::thread::id thread_{std::this_thread::get_id()};
+    std::deque<std::function<void()>> local_;                   // posted by the loop itself
+    utils::concurrent::ring<std::function<void()>> posted_;     // posted by other threads
+};
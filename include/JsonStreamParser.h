@@ -0,0 +1,219 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <stdexcept>
+#include <string_view>
+
+namespace utils::json {
+    /**
+     * A SAX style JSON parser that is fed the text in chunks of any size, e.g. straight from a pipe
+     * @note only the current token and the nesting are kept in memory, however long the text is
+     * @tparam Handler Type receiving the events, it must provide startObject(), endObject(), startArray(), endArray()
+     * and key(), string(), number(), literal() taking a std::string_view that is valid during the call only
+     */
+    template<typename Handler>
+    class StreamParser {
+    public:
+        explicit StreamParser(Handler &handler) : handler_(handler) {}
+
+        /**
+         * Parses the next chunk of the text
+         * @param chunk the chunk, tokens may be split across chunks
+         * @throws std::runtime_error if the text is malformed
+         */
+        void feed(std::string_view chunk) noexcept(false) {
+            for (auto it{chunk.begin()}; it < chunk.end(); ++it) {
+                auto c{*it};
+                switch (state_) {
+                    case State::STRING:
+                        if (c != '\\') endSurrogate();
+                        if (c == '"') {
+                            state_ = State::VALUE;
+                            if (expectKey_) {
+                                expectKey_ = false;
+                                handler_.key(token_);
+                            } else {
+                                handler_.string(token_);
+                            }
+                        } else if (c == '\\') {
+                            state_ = State::ESCAPE;
+                        } else {
+                            token_.append(1, c);
+                        }
+                        continue;
+                    case State::ESCAPE:
+                        state_ = State::STRING;
+                        if (c == 'u') {
+                            state_ = State::UNICODE;
+                            codePoint_ = 0;
+                            hexDigits_ = 0;
+                        } else {
+                            endSurrogate();
+                            token_.append(1, unescape(c));
+                        }
+                        continue;
+                    case State::UNICODE:
+                        codePoint_ = codePoint_ * 16 + hexValue(c);
+                        if (++hexDigits_ == 4) {
+                            appendEscaped(codePoint_);
+                            state_ = State::STRING;
+                        }
+                        continue;
+                    case State::SCALAR:
+                        if (isScalarChar(c)) {
+                            token_.append(1, c);
+                            continue;
+                        }
+                        endScalar();
+                        break;      // the delimiter is handled as part of the value state
+                    case State::VALUE:
+                        break;
+                }
+
+                switch (c) {
+                    case '{':
+                        nesting_.push_back('{');
+                        expectKey_ = true;
+                        handler_.startObject();
+                        break;
+                    case '[':
+                        nesting_.push_back('[');
+                        handler_.startArray();
+                        break;
+                    case '}':
+                    case ']':
+                        if (nesting_.empty() || nesting_.back() != (c == '}' ? '{' : '['))
+                            throw std::runtime_error("Malformed JSON: unbalanced brackets");
+                        nesting_.pop_back();
+                        expectKey_ = false;
+                        c == '}' ? handler_.endObject() : handler_.endArray();
+                        break;
+                    case ',':
+                        expectKey_ = !nesting_.empty() && nesting_.back() == '{';
+                        break;
+                    case '"':
+                        token_.clear();
+                        state_ = State::STRING;
+                        break;
+                    case ':':
+                    case ' ':
+                    case '\n':
+                    case '\r':
+                    case '\t':
+                        break;
+                    default:
+                        if (!isScalarChar(c)) throw std::runtime_error("Malformed JSON: unexpected character");
+                        token_.assign(1, c);
+                        state_ = State::SCALAR;
+                }
+            }
+        }
+
+        /**
+         * Ends the text, flushing a number or a literal at its end
+         * @throws std::runtime_error if the text is incomplete
+         */
+        void finish() noexcept(false) {
+            if (state_ == State::SCALAR) endScalar();
+            if (state_ != State::VALUE || !nesting_.empty()) throw std::runtime_error("Malformed JSON: incomplete");
+        }
+
+    private:
+        static constexpr unsigned int replacementCharacter = 0xFFFD;
+
+        enum class State {
+            VALUE, STRING, ESCAPE, UNICODE, SCALAR
+        };
+
+        static bool isScalarChar(char c) {
+            return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || c == '-' || c == '+' || c == '.' || c == 'E';
+        }
+
+        static char unescape(char c) {
+            switch (c) {
+                case 'n':
+                    return '\n';
+                case 't':
+                    return '\t';
+                case 'r':
+                    return '\r';
+                case 'b':
+                    return '\b';
+                case 'f':
+                    return '\f';
+                default:
+                    return c;   // '"', '\\' and '/'
+            }
+        }
+
+        static unsigned int hexValue(char c) {
+            if (c >= '0' && c <= '9') return c - '0';
+            if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+            if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+            throw std::runtime_error("Malformed JSON: invalid unicode escape");
+        }
+
+        /**
+         * Appends an escaped UTF-16 code unit, a high surrogate is held until the low one of its pair follows
+         */
+        void appendEscaped(unsigned int codeUnit) {
+            if (codeUnit >= 0xDC00 && codeUnit <= 0xDFFF && highSurrogate_) {
+                appendUtf8(0x10000 + ((highSurrogate_ - 0xD800) << 10) + (codeUnit - 0xDC00));
+                highSurrogate_ = 0;
+                return;
+            }
+            endSurrogate();
+            if (codeUnit >= 0xD800 && codeUnit <= 0xDBFF)
+                highSurrogate_ = codeUnit;
+            else
+                appendUtf8(codeUnit >= 0xDC00 && codeUnit <= 0xDFFF ? replacementCharacter : codeUnit);
+        }
+
+        /**
+         * Replaces a held high surrogate that isn't followed by a low one
+         */
+        void endSurrogate() {
+            if (!highSurrogate_) return;
+            highSurrogate_ = 0;
+            appendUtf8(replacementCharacter);
+        }
+
+        void appendUtf8(unsigned int codePoint) {
+            if (codePoint < 0x80) {
+                token_.append(1, static_cast<char>(codePoint));
+            } else if (codePoint < 0x800) {
+                token_.append(1, static_cast<char>(0xC0 | (codePoint >> 6)));
+                token_.append(1, static_cast<char>(0x80 | (codePoint & 0x3F)));
+            } else if (codePoint < 0x10000) {
+                token_.append(1, static_cast<char>(0xE0 | (codePoint >> 12)));
+                token_.append(1, static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+                token_.append(1, static_cast<char>(0x80 | (codePoint & 0x3F)));
+            } else {
+                token_.append(1, static_cast<char>(0xF0 | (codePoint >> 18)));
+                token_.append(1, static_cast<char>(0x80 | ((codePoint >> 12) & 0x3F)));
+                token_.append(1, static_cast<char>(0x80 | ((codePoint >> 6) & 0x3F)));
+                token_.append(1, static_cast<char>(0x80 | (codePoint & 0x3F)));
+            }
+        }
+
+        void endScalar() {
+            state_ = State::VALUE;
+            if (token_ == "true" || token_ == "false" || token_ == "null")
+                handler_.literal(token_);
+            else if ((token_[0] >= '0' && token_[0] <= '9') || token_[0] == '-')
+                handler_.number(token_);
+            else
+                throw std::runtime_error("Malformed JSON: invalid literal");
+        }
+
+        Handler &handler_;
+        State state_ = State::VALUE;
+        bool expectKey_ = false;
+        std::string token_;
+        std::vector<char> nesting_;
+        unsigned int codePoint_ = 0;
+        unsigned int hexDigits_ = 0;
+        unsigned int highSurrogate_ = 0;    // of an escaped pair, waiting for the low one
+    };
+}
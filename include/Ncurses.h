@@ -2,17 +2,44 @@
 
 #include <ncurses.h>
 #include <string>
-#include <chrono>
+#include <vector>
+#include <optional>
+#include <string_view>
+
+#include "WrapCache.h"
 
 #define PUT_CENTERED(screen, string, line) screen.putCentered(string, line, sizeof(string))
-#define PUT_CENTERED_FOR(screen, string, line, duration) screen.putCenteredFor(string, line, sizeof(string), duration)
 
 class Ncurses {
 public:
+    /**
+     * The frames written to the terminal since ncurses was initialized
+     */
+    struct FrameStats {
+        unsigned long frames = 0;
+        unsigned long long bytes = 0;           // 0 if the kernel doesn't account the bytes written per thread
+        unsigned long long lastFrameBytes = 0;
+        unsigned long long maxFrameBytes = 0;
+    };
+
     explicit Ncurses();
 
     ~Ncurses();
 
+    /**
+     * Writes the lines changed on every screen since the last frame with a single doupdate
+     * @note the screens are stacked in the order they were created, the last one is on top
+     */
+    static void render();
+
+    /**
+     * Get the frames rendered so far and the bytes they wrote to the terminal
+     */
+    static const FrameStats &frameStats();
+
+    /**
+     * The drawing calls only record the changed lines, nothing reaches the terminal before Ncurses::render()
+     */
     class Screen {
     public:
         explicit Screen(WINDOW *window) noexcept(false);
@@ -27,6 +54,12 @@ public:
          */
         int getCharToLower() const;
 
+        /**
+         * Makes getCharToLower return ERR right away instead of waiting when no key was pressed
+         * @param nonBlocking whether reading a key waits for it
+         */
+        void setNonBlocking(bool nonBlocking) const;
+
         /**
          * Get the number of lines of this screen
          * @return the number of lines
@@ -58,26 +91,12 @@ public:
         void putAt(const std::wstring &string, int y, int x) const;
 
         /**
-         * Puts a line at y, x coordinates on a screen for a specific duration of time
-         * @note suspends the thread that calls the function
-         * @note if string can't fit on the line it's trimmed
-         * @param string the string to be printed
+         * Draws a row of a bitmap at y, x coordinates over what the line shows, without clearing the rest of it
+         * @param row the cells of the row, a space is a blank cell and any other char a solid one
          * @param y the line index
-         * @param x the colum index
-         * @param duration the duration of display
-         */
-        void putFor(const std::string &string, int y, int x, std::chrono::seconds duration) const;
-
-        /**
-         * Puts a line at y, x coordinates on a screen for a specific duration of time
-         * @note suspends the thread that calls the function
-         * @note if string can't fit on the line it's trimmed
-         * @param string to be printed
-         * @param y the line index
-         * @param x the colum index
-         * @param duration the duration of display
+         * @param x the column index
          */
-        void putFor(const std::wstring &string, int y, int x, std::chrono::seconds duration) const;
+        void putBitmap(std::string_view row, int y, int x) const;
 
         /**
          * Puts a line at y, x coordinates on a screen if the line fits in the specified width, otherwise the line is
@@ -85,7 +104,7 @@ public:
          * @param string the string to be printed
          * @param y the line index
          * @param x the column index
-         * @param width the maximum width to wrap after
+         * @param width the maximum number of terminal cells to wrap after
          */
         void putWrapped(const std::string &string, int y, int x, int width) const;
 
@@ -95,7 +114,7 @@ public:
          * @param string the string to be printed
          * @param y the line index
          * @param x the column index
-         * @param width the maximum width to wrap after
+         * @param width the maximum number of terminal cells to wrap after
          */
         void putWrapped(const std::wstring &string, int y, int x, int width) const;
 
@@ -104,7 +123,7 @@ public:
          * is wrapped such that the last word will be on the line at y index
          * @param string the string to be printed
          * @param y the line index
-         * @param width the maximum width to wrap after
+         * @param width the maximum number of terminal cells to wrap after
          */
         void putCentered(const std::string &string, int y, int width) const;
 
@@ -113,54 +132,64 @@ public:
          * is wrapped such that the last word will be on the line at y index
          * @param string the string to be printed
          * @param y the line index
-         * @param width the maximum width to wrap after
+         * @param width the maximum number of terminal cells to wrap after
          */
         void putCentered(const std::wstring &string, int y, int width) const;
 
         /**
-         * Puts a line for a specific duration centered at y coordinate on a screen if the line fits in the specified
-         * width, otherwise the line is wrapped such that the last word will be on the line at y index
-         * @param string the string to be printed
-         * @param y the line index
-         * @param width the maximum width to wrap after
-         * @param duration the duration of display
+         * Clears the screen
          */
-        void putCenteredFor(const std::string &string, int y, int width, std::chrono::seconds duration) const;
+        void clear();
 
         /**
-         * Puts a line for a specific duration centered at y coordinate on a screen if the line fits in the specified
-         * width, otherwise the line is wrapped such that the last word will be on the line at y index
-         * @param string the string to be printed
-         * @param y the line index
-         * @param width the maximum width to wrap after
-         * @param duration the duration of display
+         * Copies the changes of the screen to the virtual screen of ncurses without writing them to the terminal
+         * @param covered whether a screen below it was staged, the whole screen is copied again to stay on top
+         * @return false if nothing was copied
          */
-        void putCenteredFor(const std::wstring &string, int y, int width, std::chrono::seconds duration) const;
+        bool stage(bool covered);
 
         /**
-         * Ask the user a question and get the pressed key back
-         * @param string question to show the user
-         * @param validChars allowed key presses as responses
-         * @param retries number of retries if invalid key is pressed
-         * @return the pressed key as an answer
+         * Updates the screen to use the new number of lines and cols
+         * @param lines the number of lines
+         * @param cols the number of columns
          */
-        int ask(const std::wstring &string, const std::wstring &validChars, unsigned int retries) const;
+        void resize(int lines, int cols);
 
+    private:
         /**
-         * Clears the screen
+         * What was last drawn on a line
          */
-        void clear();
+        struct Line {
+            int x = -1;
+            std::string text;
+            std::wstring wtext;
+        };
 
         /**
-         * Updates the screen to use the new number of lines and cols
-         * @param lines the number of lines
-         * @param cols the number of columns
+         * Clears a line and draws a string on it unless the line already shows it
          */
-        void resize(int lines, int cols);
+        template<typename Char>
+        void draw(std::basic_string_view<Char> string, int y, int x) const;
+
+        /**
+         * Draws the wrapped lines of a string such that the last one is on the line at y
+         * @param x the column index, or nothing to center each line
+         * @return the number of lines
+         */
+        template<typename Char>
+        int putLines(std::basic_string_view<Char> string, int y, std::optional<int> x, int width) const;
+
+        /**
+         * Forgets what the lines show, after the whole window was cleared
+         */
+        void reset();
 
-    private:
         WINDOW *window_ = stdscr;
         int lines_ = LINES;
         int cols_ = COLS;
+        mutable std::vector<Line> shown_;  // a put that shows what a line already shows draws nothing
+        mutable bool dirty_ = false;
+        mutable utils::text::WrapCache<char> layouts_;         // cleared on resize
+        mutable utils::text::WrapCache<wchar_t> wideLayouts_;
     };
 };
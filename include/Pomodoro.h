@@ -0,0 +1,132 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <optional>
+#include <functional>
+
+#include "Timew.h"
+#include "EventLoop.h"
+#include "DeadlineTimer.h"
+#include "SessionQueue.h"
+#include "TerminalView.h"
+#include "StatusSegment.h"
+#include "TimewExecutor.h"
+#include "sound/AudioPlayer.h"
+
+/**
+ * Runs the pomodoro sessions on the event loop, a new session replaces the current one
+ */
+class Pomodoro {
+public:
+    /**
+     * @param loop the event loop the sessions run on
+     * @param view the terminal interface, or nullptr when headless
+     * @param status the segment the state of the session is published to, or nullptr
+     * @param audioPlayer plays the sounds at the end of the sessions
+     * @param focusTrack an ogg file looped during the focus count downs, or empty
+     */
+    Pomodoro(EventLoop &loop, TerminalView *view, StatusSegment *status, AudioPlayer &audioPlayer,
+             std::string focusTrack) noexcept(false);
+
+    Pomodoro(const Pomodoro &) = delete;
+
+    Pomodoro &operator=(const Pomodoro &) = delete;
+
+    ~Pomodoro();
+
+    /**
+     * Queues a session, the queued sessions start after the events of the current loop iteration
+     */
+    void push(const SessionQueue::Session &task);
+
+    /**
+     * Stops the count down and tracking, ahead of the queued sessions
+     */
+    void pause();
+
+    /**
+     * Get the number of sessions and timew commands that were coalesced instead of run
+     */
+    [[nodiscard]] CoalesceStats coalesced() const;
+
+    /**
+     * Follows tracking started or stopped by other tools
+     */
+    void trackingChanged(bool isTracking);
+
+    [[nodiscard]] bool isPaused() const;
+
+    /**
+     * Get the state of the session as published to the status segment
+     */
+    [[nodiscard]] const StatusSegment::Status &status() const;
+
+    /**
+     * Shows an error on the terminal, or on stderr when headless
+     */
+    void report(const std::string &message);
+
+private:
+    struct CountDown {
+        StatusSegment::Phase phase;
+        std::string title;
+        std::string taskDescription;
+        std::chrono::nanoseconds deadline;  // the tick shown, on the clock of the timer
+        std::chrono::nanoseconds end;
+        std::function<void()> finished;
+    };
+
+    void runTasks();
+
+    void start(const SessionQueue::Session &task);
+
+    /**
+     * Counts the focus down, then the break
+     * @param tracking the interval being tracked, a resumed session counts the time it already tracked
+     */
+    void startFocus(const SessionQueue::Session &task, const TimewQueryResult &tracking);
+
+    /**
+     * Stops the session without touching tracking, the time left stays published as paused
+     */
+    void interrupt();
+
+    void stopSession();
+
+    void startCountDown(StatusSegment::Phase phase, const std::string &title, const std::string &taskDescription,
+                        std::chrono::nanoseconds duration, std::function<void()> finished);
+
+    void stopCountDown();
+
+    /**
+     * Streams the focus track from the start, it loops until the count down ends or stops
+     */
+    void playFocusTrack();
+
+    void stopFocusTrack();
+
+    void tick();
+
+    void draw();
+
+    /**
+     * Publishes the state of the session, the readers count the time left down themselves from its end
+     */
+    void publish(const StatusSegment::Status &status);
+
+    EventLoop &loop_;
+    TerminalView *view_;
+    StatusSegment *status_;
+    AudioPlayer &audioPlayer_;
+    std::string focusTrack_;
+    TimewExecutor executor_;
+    DeadlineTimer timer_;       // BOOTTIME, the time suspended counts against the session
+
+    SessionQueue tasks_;
+    std::optional<CountDown> countDown_;
+    StatusSegment::Status current_;
+    unsigned int session_ = 0;  // callbacks of a replaced or paused session are ignored
+    bool isPause_ = true;
+    bool isFocus_ = false;
+};
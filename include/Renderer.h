@@ -0,0 +1,67 @@
+#pragma once
+
+#include <deque>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <functional>
+
+#include "Ncurses.h"
+#include "EventLoop.h"
+#include "DeadlineTimer.h"
+
+/**
+ * Owns the terminal on the event loop, every ncurses call runs on the loop thread and the screens are written as one
+ * frame per loop iteration
+ * @note other threads hand their drawing over through draw(), which queues it on the loop
+ */
+class Renderer {
+public:
+    /**
+     * @param loop the event loop the frames are rendered on, from the thread that runs it
+     * @param toastScreen the screen whose last line shows the toasts
+     */
+    Renderer(EventLoop &loop, const Ncurses::Screen &toastScreen) noexcept(false);
+
+    Renderer(const Renderer &) = delete;
+
+    Renderer &operator=(const Renderer &) = delete;
+
+    ~Renderer();
+
+    /**
+     * Runs a draw command on the loop thread, right away if called from it
+     * @note thread-safe
+     */
+    void draw(std::function<void()> command);
+
+    /**
+     * Shows a message until its deadline without waiting for it, a newer toast covers it meanwhile
+     * @note thread-safe
+     * @param message the message
+     * @param duration the time the message is shown
+     */
+    void toast(std::string message, std::chrono::milliseconds duration);
+
+    /**
+     * Shows the toast that is still due again, e.g. after the screen was cleared
+     */
+    void redraw();
+
+private:
+    struct Toast {
+        std::string message;
+        std::chrono::nanoseconds deadline;  // on the clock of the timer
+    };
+
+    /**
+     * Drops the expired toasts and shows the newest one left
+     */
+    void expire();
+
+    EventLoop &loop_;
+    const Ncurses::Screen &toastScreen_;
+    std::thread::id thread_{std::this_thread::get_id()};
+    DeadlineTimer timer_{DeadlineTimer::Clock::MONOTONIC};
+    std::deque<Toast> toasts_;  // oldest first
+};
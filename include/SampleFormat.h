@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace utils::pcm {
+    /**
+     * The sample encodings of .wav files, little endian
+     */
+    enum class Encoding : uint8_t {
+        UNSIGNED_8,
+        SIGNED_16,
+        SIGNED_24,
+        SIGNED_32,
+        FLOAT_32
+    };
+
+    /**
+     * Get the number of bytes a sample takes
+     */
+    constexpr std::size_t sampleBytes(Encoding encoding) {
+        switch (encoding) {
+            case Encoding::UNSIGNED_8:
+                return 1;
+            case Encoding::SIGNED_16:
+                return 2;
+            case Encoding::SIGNED_24:
+                return 3;
+            default:
+                return 4;
+        }
+    }
+
+    /**
+     * Converts samples to signed 16 bits, the wider integers are truncated and the floats are rounded and clipped
+     * @note 16 bytes at a time with SSE2 or NEON when available, SSSE3 for 24 bits
+     * @param encoding the encoding of the samples
+     * @param samples the samples, a trailing partial sample is ignored
+     * @param out room for samples.size() / sampleBytes(encoding) samples
+     */
+    void toSigned16(Encoding encoding, std::string_view samples, int16_t *out);
+
+    /**
+     * The same conversion one sample at a time, the reference of the vector kernels
+     */
+    void toSigned16Scalar(Encoding encoding, std::string_view samples, int16_t *out);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <deque>
+#include <optional>
+
+#include "Timew.h"
+
+/**
+ * The sessions waiting for the next loop iteration, collapsed by kind so that a burst of signals or key presses
+ * starts a single session
+ * @note STOP and RESUME are control commands and go ahead of the queued QUERY sessions
+ */
+class SessionQueue {
+public:
+    typedef PomodoroSession<int64_t, std::nano> Session;
+
+    /**
+     * Queues a session, coalescing it with the queued ones
+     * @note the last QUERY replaces the queued one, a STOP drops the queued sessions it would end anyway and a RESUME
+     * is dropped if a STOP is queued
+     */
+    void push(const Session &session);
+
+    /**
+     * Pops the session to run first
+     */
+    std::optional<Session> pop();
+
+    [[nodiscard]] bool empty() const;
+
+    /**
+     * Get the number of sessions merged or dropped since the queue was created
+     */
+    [[nodiscard]] const CoalesceStats &stats() const;
+
+private:
+    std::deque<Session> sessions_;
+    CoalesceStats stats_;
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+/**
+ * Publishes the state of the session in a POSIX shared memory segment, so that status bars read it without talking
+ * to the process or spawning timew
+ * @note the status is guarded by a seqlock, the writer never waits for the readers and a reader retries the copy
+ * it raced with
+ */
+class StatusSegment {
+public:
+    enum class Phase : uint8_t {
+        IDLE,
+        FOCUS,
+        BREAK
+    };
+
+    /**
+     * The published state, copied as a whole
+     */
+    struct Status {
+        int64_t end = 0;        // the end of the count down in nanoseconds on CLOCK_BOOTTIME, 0 if it isn't counting
+        int64_t remaining = 0;  // the nanoseconds left when the count down was paused
+        Phase phase = Phase::IDLE;
+        bool paused = false;
+        char task[238]{};       // UTF-8, NUL terminated
+
+        /**
+         * Copies a task description, cut on a character boundary if it's too long
+         */
+        void setTask(std::string_view description);
+    };
+
+    static_assert(std::is_trivially_copyable_v<Status> && sizeof(Status) % sizeof(uint64_t) == 0,
+                  "the status is copied as whole words");
+
+    /**
+     * Get the name of the segment of the current user
+     */
+    static std::string defaultName();
+
+    /**
+     * Creates the segment, or takes over the one left by a process that exited
+     * @param name the name of the segment, starting with '/'
+     * @throws std::runtime_error if the segment can't be created or another process publishes to it
+     */
+    explicit StatusSegment(std::string name = defaultName()) noexcept(false);
+
+    StatusSegment(const StatusSegment &) = delete;
+
+    StatusSegment &operator=(const StatusSegment &) = delete;
+
+    /**
+     * Removes the segment, the readers see that nothing publishes anymore
+     */
+    ~StatusSegment();
+
+    /**
+     * Replaces the published status
+     * @note never blocks, a single process publishes
+     */
+    void publish(const Status &status);
+
+    /**
+     * Reads the status published to a segment
+     * @param name the name of the segment
+     * @return the status, or nothing if no process publishes to the segment
+     */
+    static std::optional<Status> read(const std::string &name = defaultName());
+
+    /**
+     * Formats a status as a line, the format expands %s to focus, break, paused or idle, %r to the time left as
+     * [H:]MM:SS, %t to the task description and %% to %
+     * @param status the status
+     * @param format the format, an empty one is "%s %r %t", or "%s" for an idle timer
+     */
+    static std::string format(const Status &status, std::string_view format = {});
+
+private:
+    struct Layout;
+
+    std::string name_;
+    int fd_ = -1;
+    Layout *layout_ = nullptr;
+};
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <optional>
+
+#include "Ncurses.h"
+#include "BigClock.h"
+#include "Renderer.h"
+#include "EventLoop.h"
+
+/**
+ * The ncurses interface, the commands and stats on the whole terminal and the timer over them
+ */
+class TerminalView {
+public:
+    explicit TerminalView(EventLoop &loop) noexcept(false);
+
+    TerminalView(const TerminalView &) = delete;
+
+    TerminalView &operator=(const TerminalView &) = delete;
+
+    /**
+     * Get the screen the keys are read from
+     */
+    [[nodiscard]] const Ncurses::Screen &input() const;
+
+    /**
+     * Clears the screen for a new session
+     */
+    void clear();
+
+    /**
+     * Shows today's and this week's focus time under the commands, and the streak of tracked days and the most
+     * tracked tags of the week when they're available
+     * @note the export and the history are read on a thread, the line is drawn once they're done
+     */
+    void showStats(std::chrono::seconds focusDuration);
+
+    /**
+     * Shows the time left of a count down
+     */
+    void showCountDown(const std::string &title, const std::string &taskDescription,
+                       std::chrono::nanoseconds remaining);
+
+    void toast(std::string message, std::chrono::milliseconds duration);
+
+    /**
+     * Fits the screens and the clock to the size of the terminal and draws them again
+     */
+    void resize();
+
+private:
+    struct CountDown {
+        std::string title;
+        std::string taskDescription;
+        std::string time;
+    };
+
+    /**
+     * Reads the stats, blocking on `timew export` and the data files
+     * @param width the number of cells the tags of the line are fitted in
+     * @return the line or an empty string if the stats aren't available
+     */
+    static std::string statsLine(std::chrono::seconds focusDuration, int width);
+
+    void drawCountDown();
+
+    Ncurses ncurses_;                   // handle initialization of ncurses
+    Ncurses::Screen cmdScreen_{stdscr};
+    Ncurses::Screen tmrScreen_;
+    Renderer renderer_;
+    BigClock clock_{tmrScreen_};
+    std::optional<CountDown> countDown_;    // drawn again after a resize
+    bool statsRunning_ = false;
+    std::optional<std::chrono::seconds> statsPending_;
+    std::jthread statsThread_;              // joined first, before the renderer it draws through
+};
@@ -0,0 +1,170 @@
+#pragma once
+
+#include <cstddef>
+#include <string_view>
+
+namespace utils::text {
+    /**
+     * A range of code points, both ends included
+     */
+    struct Range {
+        char32_t first;
+        char32_t last;
+    };
+
+    /**
+     * The East Asian Wide and Fullwidth code points, which take two cells of a terminal
+     */
+    inline constexpr Range wideRanges[]{
+            {0x1100,  0x115F},  {0x231A,  0x231B},  {0x2329,  0x232A},  {0x23E9,  0x23EC},  {0x23F0,  0x23F0},
+            {0x23F3,  0x23F3},  {0x25FD,  0x25FE},  {0x2614,  0x2615},  {0x2648,  0x2653},  {0x267F,  0x267F},
+            {0x2693,  0x2693},  {0x26A1,  0x26A1},  {0x26AA,  0x26AB},  {0x26BD,  0x26BE},  {0x26C4,  0x26C5},
+            {0x26CE,  0x26CE},  {0x26D4,  0x26D4},  {0x26EA,  0x26EA},  {0x26F2,  0x26F3},  {0x26F5,  0x26F5},
+            {0x26FA,  0x26FA},  {0x26FD,  0x26FD},  {0x2705,  0x2705},  {0x270A,  0x270B},  {0x2728,  0x2728},
+            {0x274C,  0x274C},  {0x274E,  0x274E},  {0x2753,  0x2755},  {0x2757,  0x2757},  {0x2795,  0x2797},
+            {0x27B0,  0x27B0},  {0x27BF,  0x27BF},  {0x2B1B,  0x2B1C},  {0x2B50,  0x2B50},  {0x2B55,  0x2B55},
+            {0x2E80,  0x303E},  {0x3041,  0x33FF},  {0x3400,  0x4DBF},  {0x4E00,  0x9FFF},  {0xA000,  0xA4CF},
+            {0xA960,  0xA97F},  {0xAC00,  0xD7A3},  {0xF900,  0xFAFF},  {0xFE10,  0xFE19},  {0xFE30,  0xFE6F},
+            {0xFF00,  0xFF60},  {0xFFE0,  0xFFE6},  {0x16FE0, 0x16FE4}, {0x17000, 0x18CFF}, {0x1B000, 0x1B2FF},
+            {0x1F004, 0x1F004}, {0x1F0CF, 0x1F0CF}, {0x1F18E, 0x1F18E}, {0x1F191, 0x1F19A}, {0x1F200, 0x1F202},
+            {0x1F210, 0x1F23B}, {0x1F240, 0x1F248}, {0x1F250, 0x1F251}, {0x1F260, 0x1F265}, {0x1F300, 0x1F320},
+            {0x1F32D, 0x1F335}, {0x1F337, 0x1F37C}, {0x1F37E, 0x1F393}, {0x1F3A0, 0x1F3CA}, {0x1F3CF, 0x1F3D3},
+            {0x1F3E0, 0x1F3F0}, {0x1F3F4, 0x1F3F4}, {0x1F3F8, 0x1F43E}, {0x1F440, 0x1F440}, {0x1F442, 0x1F4FC},
+            {0x1F4FF, 0x1F53D}, {0x1F54B, 0x1F54E}, {0x1F550, 0x1F567}, {0x1F57A, 0x1F57A}, {0x1F595, 0x1F596},
+            {0x1F5A4, 0x1F5A4}, {0x1F5FB, 0x1F64F}, {0x1F680, 0x1F6C5}, {0x1F6CC, 0x1F6CC}, {0x1F6D0, 0x1F6D2},
+            {0x1F6D5, 0x1F6D7}, {0x1F6DC, 0x1F6DF}, {0x1F6EB, 0x1F6EC}, {0x1F6F4, 0x1F6FC}, {0x1F7E0, 0x1F7EB},
+            {0x1F7F0, 0x1F7F0}, {0x1F90C, 0x1F93A}, {0x1F93C, 0x1F945}, {0x1F947, 0x1F9FF}, {0x1FA70, 0x1FAFF},
+            {0x20000, 0x2FFFD}, {0x30000, 0x3FFFD}};
+
+    /**
+     * The combining marks, format characters and variation selectors, which take no cell and join the character
+     * before them
+     */
+    inline constexpr Range zeroWidthRanges[]{
+            {0x0300,  0x036F},  {0x0483,  0x0489},  {0x0591,  0x05BD},  {0x05BF,  0x05BF},  {0x05C1,  0x05C2},
+            {0x05C4,  0x05C5},  {0x05C7,  0x05C7},  {0x0610,  0x061A},  {0x064B,  0x065F},  {0x0670,  0x0670},
+            {0x06D6,  0x06DC},  {0x06DF,  0x06E4},  {0x06E7,  0x06E8},  {0x06EA,  0x06ED},  {0x0900,  0x0902},
+            {0x093A,  0x093A},  {0x093C,  0x093C},  {0x0941,  0x0948},  {0x094D,  0x094D},  {0x0951,  0x0957},
+            {0x0E31,  0x0E31},  {0x0E34,  0x0E3A},  {0x0E47,  0x0E4E},  {0x1160,  0x11FF},  {0x1AB0,  0x1AFF},
+            {0x1DC0,  0x1DFF},  {0x200B,  0x200F},  {0x202A,  0x202E},  {0x2060,  0x2064},  {0x20D0,  0x20FF},
+            {0xFE00,  0xFE0F},  {0xFE20,  0xFE2F},  {0xFEFF,  0xFEFF},  {0xE0001, 0xE0001}, {0xE0020, 0xE007F},
+            {0xE0100, 0xE01EF}};
+
+    template<std::size_t N>
+    constexpr bool isSorted(const Range (&ranges)[N]) {
+        for (std::size_t i{0}; i < N; ++i) {
+            if (ranges[i].first > ranges[i].last || (i > 0 && ranges[i - 1].last >= ranges[i].first)) return false;
+        }
+        return true;
+    }
+
+    static_assert(isSorted(wideRanges) && isSorted(zeroWidthRanges), "the ranges are binary searched");
+
+    template<std::size_t N>
+    constexpr bool contains(const Range (&ranges)[N], char32_t c) {
+        if (c < ranges[0].first || c > ranges[N - 1].last) return false;
+        std::size_t low{0}, high{N};
+        while (low < high) {
+            auto middle{(low + high) / 2};
+            if (c > ranges[middle].last) low = middle + 1;
+            else if (c < ranges[middle].first) high = middle;
+            else return true;
+        }
+        return false;
+    }
+
+    /**
+     * Get the number of terminal cells a code point takes, like wcwidth without depending on the locale
+     * @note ASCII always takes one cell, the other control characters none
+     */
+    constexpr int cellWidth(char32_t c) {
+        if (c < 0x80) return 1;
+        if (c < 0xA0) return 0;
+        if (contains(zeroWidthRanges, c)) return 0;
+        return contains(wideRanges, c) ? 2 : 1;
+    }
+
+    static_assert(cellWidth(U'a') == 1 && cellWidth(U'\u00E9') == 1 && cellWidth(U'\u0301') == 0 &&
+                  cellWidth(U'\u4E2D') == 2 && cellWidth(U'\U0001F345') == 2 && cellWidth(U'\uFF21') == 2);
+
+    inline constexpr char32_t replacementCharacter{0xFFFD};
+
+    /**
+     * Decodes the UTF-8 code point at a position
+     * @param text the UTF-8 text
+     * @param pos the position of the code point, moved past it
+     * @return the code point, or U+FFFD for a malformed sequence, which is skipped one byte at a time
+     */
+    constexpr char32_t decode(std::string_view text, std::size_t &pos) {
+        auto lead{static_cast<unsigned char>(text[pos++])};
+        if (lead < 0x80) return lead;
+
+        int length{lead >= 0xC2 && lead <= 0xDF ? 2 : lead >= 0xE0 && lead <= 0xEF ? 3 :
+                   lead >= 0xF0 && lead <= 0xF4 ? 4 : 0};
+        if (length == 0 || pos + length - 1 > text.size()) return replacementCharacter;
+
+        char32_t c{static_cast<char32_t>(lead & (0x7F >> length))};
+        for (auto i{1}; i < length; ++i) {
+            auto next{static_cast<unsigned char>(text[pos + i - 1])};
+            if ((next & 0xC0) != 0x80) return replacementCharacter;
+            c = (c << 6) | (next & 0x3F);
+        }
+        // overlong encodings, surrogates and code points past U+10FFFF
+        if ((length == 3 && c < 0x800) || (length == 4 && (c < 0x10000 || c > 0x10FFFF)) ||
+            (c >= 0xD800 && c <= 0xDFFF))
+            return replacementCharacter;
+        pos += length - 1;
+        return c;
+    }
+
+    /**
+     * Decodes the wide character at a position, wchar_t holds whole code points
+     */
+    constexpr char32_t decode(std::wstring_view text, std::size_t &pos) {
+        return static_cast<char32_t>(text[pos++]);
+    }
+
+    /**
+     * Get the length of the run of ASCII characters a text starts with
+     * @note scans 16 bytes at a time with SSE2 or NEON when available
+     */
+    std::size_t asciiPrefix(std::string_view text);
+
+    std::size_t asciiPrefix(std::wstring_view text);
+
+    /**
+     * Get the number of terminal cells a text takes
+     */
+    int displayWidth(std::string_view text);
+
+    int displayWidth(std::wstring_view text);
+
+    /**
+     * Get the length of the longest prefix of a text that fits in a number of cells
+     * @note the zero width characters after the prefix are part of it, and a prefix holds at least one character
+     * @param text the text
+     * @param width the number of cells
+     * @param cells set to the number of cells the prefix takes
+     * @return the length of the prefix in code units
+     */
+    template<typename Char>
+    std::size_t fit(std::basic_string_view<Char> text, int width, int &cells) {
+        std::size_t end{0};
+        cells = 0;
+        while (end < text.size()) {
+            auto room{static_cast<std::size_t>(width > cells ? width - cells : 0)};
+            if (auto run{asciiPrefix(text.substr(end, room))}; run > 0) {
+                end += run;
+                cells += static_cast<int>(run);
+                continue;
+            }
+
+            auto next{end};
+            auto w{cellWidth(decode(text, next))};
+            if (cells + w > width && end > 0) break;
+            end = next;
+            cells += w;
+        }
+        return end;
+    }
+}
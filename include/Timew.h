@@ -1,13 +1,27 @@
 #pragma once
 
 #include <chrono>
+#include <string>
+#include <optional>
+#include <vector>
+
 #include "utils.h"
+#include "TimewData.h"
+#include "TimewExport.h"
 
 enum TimewCommand {
     NONE, START, STOP, RESUME, QUERY
 };
 
 
+/**
+ * The commands that never ran because they were folded into pending ones
+ */
+struct CoalesceStats {
+    unsigned int merged = 0;    // shared the result of a pending command of the same kind
+    unsigned int dropped = 0;   // overridden or cancelled by another command
+};
+
 template<typename Rep, typename Period>
 struct PomodoroSession {
     std::chrono::duration<Rep, Period> focusDuration;
@@ -19,44 +33,59 @@ struct TimewQueryResult {
     std::chrono::seconds trackedTime;
     std::string taskDescription;
     bool isTracking;
+    std::chrono::system_clock::time_point startTime{};  // the start of the active interval
+    std::vector<std::string> tags{};                    // the tags of the active interval
+    std::optional<std::chrono::seconds> todayTotal{};   // tracked today, only read from the data files
 };
 
 class Timew {
 public:
+    static constexpr const char *executable{"/usr/bin/timew"};
+
     static utils::ProcessResult start(std::vector<std::string> &tags) noexcept(false) {
         throw std::logic_error("start not implemented");
     }
 
     static utils::ProcessResult stop() noexcept(false) {
-        return utils::executeProcess("/usr/bin/timew", {"stop", ":adjust", nullptr});
+        return utils::executeProcess(executable, arguments(TimewCommand::STOP));
     }
 
     static utils::ProcessResult resume() noexcept(false) {
-        return utils::executeProcess("/usr/bin/timew", {"continue", nullptr});
+        return utils::executeProcess(executable, arguments(TimewCommand::RESUME));
     }
 
-    static TimewQueryResult query() noexcept(false) {
-        auto result{utils::executeProcess("/usr/bin/timew", {nullptr})};
-
-        if (result.exitCode != 0) {
-            return {std::chrono::seconds(0), ""};
-        }
+    /**
+     * Get the arguments timew is executed with for a command
+     * @note QUERY is the batched `timew get` used when the data files can't be found
+     * @param command STOP, RESUME or QUERY
+     * @return the arguments terminated by nullptr
+     */
+    static std::vector<const char *> arguments(TimewCommand command) noexcept(false);
 
-        auto targetIdx{result.output.find("Total")};
-        if (targetIdx == std::string::npos) {
-            throw std::runtime_error("Failed to parse timew command output");
-        }
+    /**
+     * Queries the active interval, reading the data files directly when they can be found, otherwise with a single
+     * batched `timew get` of the DOM references it needs
+     * @return the tracked time, the start, the tags and the description of the active interval
+     */
+    static TimewQueryResult query() noexcept(false);
 
-        targetIdx += 5;     // skip "Total"
-        while (targetIdx < result.output.length() && std::isspace(result.output[targetIdx]))
-            ++targetIdx;
+    /**
+     * Aggregates the intervals of this week, streaming them from `timew export`
+     * @param focusDuration the duration of a pomodoro
+     * @param timeout the time after which the export is killed and std::runtime_error is thrown
+     * @return the focus time and the completed pomodoros of today and of this week
+     */
+    static FocusStats stats(std::chrono::seconds focusDuration,
+                            std::chrono::milliseconds timeout = std::chrono::seconds(10)) noexcept(false);
 
-        char *separatorIdx{nullptr};
-        auto hours{std::strtoul(&result.output[targetIdx], &separatorIdx, 10)};
-        auto minutes{std::strtoul(separatorIdx + 1, &separatorIdx, 10)};
-        auto seconds{std::strtoul(separatorIdx + 1, nullptr, 10)};
+    /**
+     * Queries the active interval from the data files
+     * @param dataFile the latest data file
+     */
+    static TimewQueryResult queryData(const std::filesystem::path &dataFile) noexcept(false);
 
-        return {std::chrono::seconds(hours * 60 * 60 + minutes * 60 + seconds),
-                utils::formatDescription(result.output), result.exitCode == 0};
-    }
+    /**
+     * Parses the result of the batched `timew get` of the QUERY arguments
+     */
+    static TimewQueryResult parseDom(const utils::ProcessResult &result) noexcept(false);
 };
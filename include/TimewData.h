@@ -0,0 +1,96 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <optional>
+#include <filesystem>
+#include <string_view>
+
+#include "utils.h"
+
+/**
+ * An interval as stored in a timewarrior data file
+ * e.g. inc 20220101T100000Z - 20220101T110000Z # tag "another tag"
+ */
+struct TimewInterval {
+    std::chrono::system_clock::time_point start;
+    std::chrono::system_clock::time_point end;      // the epoch while the interval is still open
+    std::string_view tags;                          // the raw tags as written after '#'
+
+    [[nodiscard]] bool isOpen() const {
+        return end == std::chrono::system_clock::time_point{};
+    }
+};
+
+/**
+ * Reads the timewarrior database directly instead of going through the timew executable
+ */
+class TimewData {
+public:
+    /**
+     * Maps a data file (e.g. ~/.timewarrior/data/2022-01.data) into memory
+     * @param path the path to the data file
+     */
+    explicit TimewData(const std::string &path) noexcept(false);
+
+    /**
+     * Finds the data directory the way timew does ($TIMEWARRIORDB, ~/.timewarrior or $XDG_DATA_HOME/timewarrior)
+     * @return the path to the data directory or an empty path if it doesn't exist
+     */
+    static std::filesystem::path dataDirectory();
+
+    /**
+     * Finds the data file holding the most recent interval
+     * @note files are named after the month their intervals start in, so the open interval is always in the
+     * latest non empty one
+     * @return the path to the data file or an empty path if there are no data files
+     */
+    static std::filesystem::path latestFile();
+
+    /**
+     * Parses a UTC timestamp in the format used by the data files (e.g. 20220101T100000Z)
+     * @param timestamp the timestamp, anything after the 16 characters of the timestamp is ignored
+     * @return the time point or nothing if the timestamp is malformed
+     */
+    static std::optional<std::chrono::system_clock::time_point> parseTimestamp(std::string_view timestamp) noexcept;
+
+    /**
+     * Parses a line of a data file
+     * @param line the line without the line end
+     * @return the interval, the tags are a view into line
+     */
+    static std::optional<TimewInterval> parseInterval(std::string_view line) noexcept;
+
+    /**
+     * Parses only the tail of the file to get its last interval
+     * @return the last interval, the tags are valid as long as this object lives
+     */
+    [[nodiscard]] std::optional<TimewInterval> lastInterval() const noexcept;
+
+    /**
+     * Sums the time tracked since a point, the file is parsed backwards only as far as its intervals reach the point
+     * @param since the time before which the intervals are ignored (e.g. the start of today)
+     * @param now the time the open interval ends at
+     * @return the tracked time
+     */
+    [[nodiscard]] std::chrono::seconds trackedSince(std::chrono::system_clock::time_point since,
+                                                    std::chrono::system_clock::time_point now) const noexcept;
+
+    /**
+     * Strips the escapes of tags (e.g. "a \"quoted\" tag") to show them to the user
+     * @param tags the raw tags of an interval
+     * @return the formatted tags
+     */
+    static std::string formatTags(std::string_view tags);
+
+    /**
+     * Splits raw tags into separate tags, removing the quotes and the escapes
+     * @param tags the raw tags of an interval
+     * @return the tags in the order they were written
+     */
+    static std::vector<std::string> splitTags(std::string_view tags);
+
+private:
+    utils::MappedFile file_;
+};
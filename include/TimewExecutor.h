@@ -0,0 +1,100 @@
+#pragma once
+
+#include <deque>
+#include <memory>
+#include <optional>
+#include <functional>
+
+#include "Timew.h"
+#include "EventLoop.h"
+#include "DeadlineTimer.h"
+
+/**
+ * Runs timew commands as child processes watched by the event loop, so that the caller never waits for a process
+ * to finish
+ */
+class TimewExecutor {
+public:
+    /**
+     * The outcome of an executed command
+     */
+    struct Completion {
+        TimewCommand command;
+        bool succeeded;
+        std::string error;              // set if the command failed to run or timew exited with an error
+        utils::ProcessResult process;   // set for STOP and RESUME
+        TimewQueryResult query;         // set for QUERY
+    };
+
+    /**
+     * Called from the event loop after each command
+     */
+    typedef std::function<void(const Completion &)> Callback;
+
+    /**
+     * @param loop the event loop the processes are watched on
+     * @param callback called after every executed command
+     * @param timeout the time after which a command is killed and fails
+     */
+    TimewExecutor(EventLoop &loop, Callback callback,
+                  std::chrono::milliseconds timeout = std::chrono::seconds(10)) noexcept(false);
+
+    TimewExecutor(const TimewExecutor &) = delete;
+
+    TimewExecutor &operator=(const TimewExecutor &) = delete;
+
+    /**
+     * Waits for the running command and executes the pending ones synchronously, without calling any callback
+     */
+    ~TimewExecutor();
+
+    /**
+     * Queues a command, coalescing it with the pending ones
+     * @note a repeated command shares the pending one, a STOP and a RESUME cancel each other and complete at once
+     * @param command the command to execute
+     * @param done called from the event loop when the command completes, after the callback of the executor
+     */
+    void submit(TimewCommand command, Callback done = {});
+
+    /**
+     * Get the number of commands that shared a pending one or cancelled each other since the executor was created
+     */
+    [[nodiscard]] const CoalesceStats &stats() const;
+
+private:
+    struct Pending {
+        TimewCommand command;
+        std::vector<Callback> done;
+    };
+
+    /**
+     * Starts the first pending command if none is running
+     */
+    void startNext();
+
+    /**
+     * Reads the output of the running process and completes it once it exited and closed its output
+     */
+    void readProcess();
+
+    void complete(Completion completion);
+
+    /**
+     * Executes a command without the event loop
+     */
+    static Completion execute(TimewCommand command);
+
+    EventLoop &loop_;
+    Callback callback_;
+    std::chrono::milliseconds timeout_;
+    DeadlineTimer timeoutTimer_{DeadlineTimer::Clock::MONOTONIC};
+    std::deque<Pending> pending_;
+    CoalesceStats stats_;
+
+    /* the running command */
+    std::optional<Pending> running_;
+    std::unique_ptr<utils::ChildProcess> process_;
+    std::string output_;
+    bool outputOpen_ = false;
+    bool exited_ = false;
+};
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string_view>
+
+#include "JsonStreamParser.h"
+
+/**
+ * An interval of `timew export`
+ */
+struct TimewExportInterval {
+    std::chrono::system_clock::time_point start;
+    std::chrono::system_clock::time_point end;      // the epoch while the interval is still open
+    unsigned int tagCount;
+};
+
+/**
+ * Parses the output of `timew export` as it streams in, intervals are passed on one at a time and never stored
+ */
+class TimewExport {
+public:
+    typedef std::function<void(const TimewExportInterval &)> Callback;
+
+    explicit TimewExport(Callback callback);
+
+    TimewExport(const TimewExport &) = delete;
+
+    TimewExport &operator=(const TimewExport &) = delete;
+
+    /**
+     * Parses the next chunk of the export
+     * @throws std::runtime_error if the export is malformed
+     */
+    void feed(std::string_view chunk) noexcept(false);
+
+    /**
+     * Ends the export
+     * @throws std::runtime_error if the export is incomplete
+     */
+    void finish() noexcept(false);
+
+    /* events of utils::json::StreamParser */
+    void startObject();
+
+    void endObject();
+
+    void startArray();
+
+    void endArray();
+
+    void key(std::string_view key);
+
+    void string(std::string_view value);
+
+    void number(std::string_view) {}
+
+    void literal(std::string_view) {}
+
+private:
+    enum class Field {
+        NONE, START, END, TAGS
+    };
+
+    Callback callback_;
+    utils::json::StreamParser<TimewExport> parser_;
+    unsigned int depth_ = 0;
+    Field field_ = Field::NONE;
+    TimewExportInterval interval_{};
+};
+
+/**
+ * The focus time and the completed pomodoros of today and of this week (starting on monday) in local time
+ */
+struct FocusStats {
+    /**
+     * @param now the time the stats are calculated at, open intervals end at it
+     * @param focusDuration the duration of a pomodoro
+     */
+    FocusStats(std::chrono::system_clock::time_point now, std::chrono::seconds focusDuration);
+
+    /**
+     * Adds the part of an interval that falls into this week
+     */
+    void add(const TimewExportInterval &interval);
+
+    std::chrono::system_clock::time_point now;
+    std::chrono::system_clock::time_point startOfToday;
+    std::chrono::system_clock::time_point startOfWeek;
+    std::chrono::seconds focusDuration;
+    std::chrono::seconds todayFocus{0};
+    std::chrono::seconds weekFocus{0};
+    unsigned int todayPomodoros = 0;
+    unsigned int weekPomodoros = 0;
+};
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <filesystem>
+#include <unordered_map>
+
+/**
+ * All the intervals of the timewarrior data files in a columnar store for long range stats
+ * @note every month is indexed into the cache directory, later loads only parse the months whose data file changed
+ */
+class TimewHistory {
+public:
+    /**
+     * Indexes every data file, the months that changed are parsed in parallel
+     * @param dataDirectory the timewarrior data directory
+     * @param indexDirectory the directory to keep the index of every month in, nothing is persisted if it's empty
+     * @return the intervals of all the months
+     */
+    static TimewHistory load(const std::filesystem::path &dataDirectory,
+                             const std::filesystem::path &indexDirectory) noexcept(false);
+
+    /**
+     * Get the number of intervals
+     */
+    [[nodiscard]] std::size_t size() const;
+
+    /**
+     * Sums the tracked time of every tag
+     * @param since the time before which intervals are ignored
+     * @param now the time open intervals end at
+     * @return the tags and their tracked time, the most tracked first
+     */
+    [[nodiscard]] std::vector<std::pair<std::string, std::chrono::seconds>>
+    focusByTag(std::chrono::system_clock::time_point since, std::chrono::system_clock::time_point now) const;
+
+    /**
+     * Counts the consecutive days with tracked time up to today, or up to yesterday if nothing was tracked today
+     * @param now the time that decides what today is in local time
+     * @return the number of days in the streak
+     */
+    [[nodiscard]] unsigned int streak(std::chrono::system_clock::time_point now) const;
+
+private:
+    /**
+     * The intervals of a single data file, tags are stored by name since ids are only assigned when merging
+     */
+    struct Month {
+        std::vector<int64_t> starts;
+        std::vector<int64_t> ends;          // 0 while the interval is open
+        std::vector<uint32_t> tagCounts;
+        std::vector<std::string> tags;
+    };
+
+    static Month parseMonth(const std::filesystem::path &dataFile) noexcept(false);
+
+    static std::optional<Month> readIndex(const std::filesystem::path &indexFile, int64_t mtime, uint64_t size);
+
+    static void writeIndex(const std::filesystem::path &indexFile, const Month &month, int64_t mtime, uint64_t size);
+
+    void append(const Month &month);
+
+    /* one entry per interval */
+    std::vector<int64_t> starts_;           // seconds since the epoch
+    std::vector<int64_t> ends_;             // seconds since the epoch, 0 while the interval is open
+    std::vector<uint32_t> tagOffsets_{0};   // the tags of interval i are tagIds_[tagOffsets_[i], tagOffsets_[i + 1])
+
+    std::vector<uint32_t> tagIds_;
+    std::vector<std::string> tagNames_;
+    std::unordered_map<std::string, uint32_t> tagIndex_;
+};
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <optional>
+#include <string_view>
+
+/**
+ * The report timew prints for an interval (e.g. by `timew`, `timew continue` or `timew stop`)
+ * @code
+ * Tracking "task description" tag
+ *   Started 2022-01-01T10:00:00
+ *   Current                11:30:00
+ *   Total                   1:30:00
+ * @endcode
+ * @note all the views point into the parsed output, nothing is copied
+ */
+struct TimewReport {
+    bool isTracking;                // "Tracking" rather than "Recorded"
+    std::string_view tags;          // the raw tags following "Tracking" or "Recorded"
+    std::string_view started;       // the value of the "Started" line
+    std::string_view current;       // the value of the "Current" or "Ended" line
+    std::chrono::seconds total;     // the value of the "Total" line
+
+    /**
+     * Parses the report out of the output of a timew command, lines before the report (e.g. notes) are skipped
+     * @param output the output of the timew command
+     * @return the report or nothing if the output has no complete report
+     */
+    static std::optional<TimewReport> parse(std::string_view output) noexcept;
+
+    /**
+     * Parses a duration in the format of the "Total" line (e.g. 1:30:00)
+     * @param duration the duration
+     * @return the duration or nothing if it's malformed
+     */
+    static std::optional<std::chrono::seconds> parseDuration(std::string_view duration) noexcept;
+
+    /**
+     * Takes the next tag off raw tags, quotes are removed but escapes are kept
+     * @param tags the raw tags, the taken tag is removed from them
+     * @param tag set to the taken tag
+     * @return false if there are no more tags
+     */
+    static bool nextTag(std::string_view &tags, std::string_view &tag) noexcept;
+
+    /**
+     * Get the tags as a task description, the quotes are kept and the escapes removed
+     */
+    [[nodiscard]] std::string description() const;
+};
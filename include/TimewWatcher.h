@@ -0,0 +1,56 @@
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <filesystem>
+
+#include "EventLoop.h"
+#include "DeadlineTimer.h"
+
+/**
+ * Watches the timewarrior data directory with inotify and reports when tracking starts or stops, whatever started
+ * it (timew, taskwarrior hooks or other tools)
+ */
+class TimewWatcher {
+public:
+    /**
+     * Called from the event loop with the new tracking state
+     */
+    typedef std::function<void(bool isTracking)> Callback;
+
+    /**
+     * Starts watching a data directory
+     * @param loop the event loop the inotify events are read on
+     * @param directory the timewarrior data directory
+     * @param callback called when tracking starts, stops or a new interval replaces the open one
+     * @param debounce the quiet time after the last write before the data files are read, timew writes several
+     * files for a single command
+     */
+    TimewWatcher(EventLoop &loop, const std::filesystem::path &directory, Callback callback,
+                 std::chrono::milliseconds debounce = std::chrono::milliseconds(20)) noexcept(false);
+
+    TimewWatcher(const TimewWatcher &) = delete;
+
+    TimewWatcher &operator=(const TimewWatcher &) = delete;
+
+    ~TimewWatcher();
+
+private:
+    /**
+     * Reads the inotify events and restarts the debounce timer if a data file was written
+     */
+    void read();
+
+    /**
+     * Reads the data files and calls the callback if the open interval changed
+     */
+    void update();
+
+    EventLoop &loop_;
+    int inotifyFd_ = -1;
+    Callback callback_;
+    std::chrono::milliseconds debounce_;
+    DeadlineTimer debounceTimer_{DeadlineTimer::Clock::MONOTONIC};
+    bool isTracking_ = false;
+    std::chrono::system_clock::time_point start_{};
+};
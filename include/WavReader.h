@@ -0,0 +1,62 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <string_view>
+
+#include "utils.h"
+#include "SampleFormat.h"
+
+/**
+ * Reader for .wav files, the chunks are walked so that extra chunks and extensible formats are read too
+ */
+class WavReader {
+public:
+    /**
+     * Signed 16 bits little endian samples, interleaved
+     */
+    class Sound {
+    public:
+        unsigned int channels = 0;
+        unsigned int sampleRate = 0;
+
+        /**
+         * Get the samples
+         * @return a view that is valid as long as this object lives
+         */
+        [[nodiscard]] std::string_view samples() const;
+
+    private:
+        friend class WavReader;
+
+        std::unique_ptr<utils::MappedFile> mapping_;   // the file, if its samples are signed 16 bits
+        std::string_view mapped_;
+        std::vector<int16_t> converted_;
+    };
+
+    /**
+     * The format and the samples of a .wav file
+     */
+    struct Format {
+        utils::pcm::Encoding encoding;
+        unsigned int channels;
+        unsigned int sampleRate;
+        std::string_view samples;   // whole frames, in the parsed file
+    };
+
+    /**
+     * Loads a .wav file, the signed 16 bits samples are mapped from the file and the others are converted
+     * @param audioFile the path of the file
+     * @throws std::runtime_error if the file can't be read, isn't a .wav file or has an unsupported format
+     */
+    static Sound load(const std::string &audioFile) noexcept(false);
+
+    /**
+     * Parses the contents of a .wav file
+     * @param riff the contents of the file
+     * @throws std::runtime_error if it isn't a .wav file or has an unsupported format
+     */
+    static Format parse(std::string_view riff) noexcept(false);
+};
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <array>
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <functional>
+#include <string_view>
+
+#include "TextWidth.h"
+
+namespace utils::text {
+    /**
+     * Wraps text on words and remembers the layouts, so that drawing the same text at the same width again only
+     * costs a hash of the text
+     * @note the cache keeps a copy of each text, the returned lines stay valid until the layout is evicted or cleared
+     * @tparam Char Type of the characters, char or wchar_t
+     * @tparam Size The number of layouts kept, the oldest one is evicted first
+     */
+    template<typename Char, std::size_t Size = 16>
+    class WrapCache {
+    public:
+        typedef std::basic_string_view<Char> View;
+
+        struct Line {
+            View text;
+            int width;  // the number of terminal cells the line takes
+        };
+
+        /**
+         * Wraps a text on the last space that fits a line, or after the last character that fits if a word doesn't
+         * @param text the text to wrap, UTF-8 for char
+         * @param width the maximum number of terminal cells of a line
+         * @return the lines as views into text
+         */
+        static std::vector<Line> wrap(View text, int width) {
+            std::vector<Line> lines;
+            if (width <= 0) return lines;
+
+            for (std::size_t i{0}; i < text.size();) {
+                auto rest{text.substr(i)};
+                int cells;
+                auto line{rest.substr(0, fit(rest, width, cells))};
+
+                // if still other chars in the text and the last char of the line isn't '\n' or ' '
+                if (line.size() < rest.size() && line.back() != '\n' && line.back() != ' ') {
+                    // a line that has no space to break on past its first char is cut after the last char that fits
+                    if (auto lastSpace{line.find_last_of(' ')}; lastSpace != View::npos && lastSpace != 0) {
+                        line = line.substr(0, lastSpace);
+                        cells = displayWidth(line);
+                    }
+                }
+                i += line.size();
+                lines.push_back({line, cells});
+            }
+
+            return lines;
+        }
+
+        /**
+         * Get the wrapped lines of a text, wrapping it only if it wasn't wrapped at this width before
+         * @param text the text to wrap
+         * @param width the maximum number of terminal cells of a line
+         * @return the lines as views into the copy of text kept by the cache
+         */
+        const std::vector<Line> &lines(View text, int width) {
+            auto hash{std::hash<View>{}(text) * 31 + static_cast<std::size_t>(width)};
+            for (auto &layout: layouts_) {
+                if (layout.used && layout.hash == hash && layout.width == width && layout.text == text)
+                    return layout.lines;
+            }
+
+            // the slots never move, so the views into their text stay valid
+            auto &layout{layouts_[next_]};
+            next_ = (next_ + 1) % Size;
+            layout.used = true;
+            layout.hash = hash;
+            layout.width = width;
+            layout.text = text;
+            layout.lines = wrap(layout.text, width);
+            return layout.lines;
+        }
+
+        /**
+         * Forgets every layout, e.g. after the screen was resized
+         */
+        void clear() {
+            for (auto &layout: layouts_) {
+                layout.used = false;
+                layout.lines.clear();
+            }
+        }
+
+    private:
+        struct Layout {
+            bool used = false;
+            std::size_t hash = 0;
+            int width = 0;
+            std::basic_string<Char> text;
+            std::vector<Line> lines;
+        };
+
+        std::array<Layout, Size> layouts_{};
+        std::size_t next_ = 0;
+    };
+}
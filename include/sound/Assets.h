@@ -0,0 +1,56 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "config.h"
+
+/**
+ * The sounds shipped with the program, the players keep them in arrays indexed by the id
+ */
+enum class SoundId : uint8_t {
+    SYNTH_BRASS,    // the end of a break
+    RETRO_SYNTH,    // the end of a focus session
+    COUNT
+};
+
+namespace assets {
+    constexpr std::size_t soundCount{static_cast<std::size_t>(SoundId::COUNT)};
+
+    /**
+     * Where the sounds are installed, in the order of the ids
+     */
+    constexpr std::array<std::string_view, soundCount> soundFiles{
+            PROJECT_INSTALL_PREFIX "/share/" PROJECT_NAME "/sounds/Synth_Brass.ogg",
+            PROJECT_INSTALL_PREFIX "/share/" PROJECT_NAME "/sounds/Retro_Synth.ogg",
+    };
+
+    constexpr std::size_t index(SoundId sound) {
+        return static_cast<std::size_t>(sound);
+    }
+
+    /**
+     * Get the installed file of a sound
+     */
+    constexpr std::string_view file(SoundId sound) {
+        return soundFiles[index(sound)];
+    }
+
+#ifdef EMBED_SOUNDS
+    /**
+     * Get the bytes of a sound built into the program
+     * @note defined by the source generated from the assets
+     */
+    std::string_view embedded(SoundId sound);
+#else
+
+    /**
+     * The sounds aren't built into the program, they're read from their files
+     */
+    constexpr std::string_view embedded(SoundId) {
+        return {};
+    }
+
+#endif
+}
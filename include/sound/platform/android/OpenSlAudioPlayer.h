@@ -1,5 +1,6 @@
 #pragma once
 
+#include <array>
 #include <string>
 #include <SLES/OpenSLES.h>
 #include <unordered_map>
@@ -8,6 +9,8 @@
 #include <SLES/OpenSLES_Android.h>
 #endif
 
+#include "sound/Assets.h"
+
 /**
  * @remark https://github.com/android/ndk-samples/blob/master/native-audio/app/src/main/cpp/native-audio-jni.c
  */
@@ -19,16 +22,32 @@ public:
     ~OpenSlAudioPlayer();
 
     /**
-     * Loads an audio file
+     * Loads a sound
+     */
+    void load(SoundId);
+
+    /**
+     * Plays a sound, a sound that wasn't loaded is ignored
+     */
+    void play(SoundId) const noexcept(true);
+
+    /**
+     * Plays an audio file from the start, OpenSL decodes it while playing
+     * @param loop whether to start over at the end until stopped
      */
-    void load(const std::string &);
+    void stream(const std::string &, bool loop);
 
     /**
-     * Plays an audio file
+     * Stops a streamed file, if it's playing
      */
-    void play(const std::string &) const noexcept(true);
+    void stop(const std::string &) const noexcept(true);
 
 private:
+    /**
+     * Creates a player of a file
+     */
+    SLPlayItf createPlayer(const std::string &, bool loop);
+
     SLEngineItf slEngineItf_{nullptr};
     SLObjectItf slEngineObj_{nullptr};
     SLObjectItf slOutputMixObj_{nullptr};
@@ -36,5 +55,6 @@ private:
 #ifdef __ANDROID__
     SLint32 androidStreamType{SL_ANDROID_STREAM_NOTIFICATION};
 #endif
-    std::unordered_map<std::string, SLPlayItf> audio_;
+    std::array<SLPlayItf, assets::soundCount> audio_{};
+    std::unordered_map<std::string, SLPlayItf> streams_;
 };
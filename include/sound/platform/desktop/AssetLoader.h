@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <deque>
+#include <mutex>
+#include <future>
+#include <thread>
+#include <vector>
+#include <condition_variable>
+
+#include "sound/Assets.h"
+#include "sound/platform/desktop/PcmCache.h"
+
+/**
+ * Decodes the registered sounds in parallel on a small pool, each sound is waited for on its own so that playing one
+ * never waits for the decoding of the others
+ * @note the samples are only decoded, uploading them to the audio device is left to the thread that owns it, the
+ * sounds built into the program are decoded from memory without going through the cache
+ */
+class AssetLoader {
+public:
+    /**
+     * @param cache the cache the sounds are loaded through
+     * @param threads the number of decoding threads
+     */
+    AssetLoader(PcmCache &cache, unsigned int threads) noexcept(false);
+
+    AssetLoader(const AssetLoader &) = delete;
+
+    AssetLoader &operator=(const AssetLoader &) = delete;
+
+    /**
+     * Stops the pool after the sounds being decoded, the queued ones are dropped
+     */
+    ~AssetLoader();
+
+    /**
+     * Registers a sound, returns right away
+     * @param sound the id of the sound
+     * @param lazy whether to defer the decoding until the sound is taken, instead of queuing it on the pool
+     */
+    void add(SoundId sound, bool lazy);
+
+    /**
+     * Waits for a sound to be decoded and takes its samples, once per sound
+     * @note a lazy sound is decoded by the calling thread
+     * @param sound the id of the sound
+     * @throws std::runtime_error if the sound wasn't registered, was taken already or failed to decode
+     */
+    PcmCache::Sound take(SoundId sound) noexcept(false);
+
+private:
+    struct Asset {
+        std::packaged_task<PcmCache::Sound()> decode;
+        std::future<PcmCache::Sound> decoded;
+        bool added = false;
+        bool started = false;   // the decoding is queued or done
+    };
+
+    void work(std::stop_token stop);
+
+    PcmCache &cache_;
+    std::mutex mutex_;
+    std::condition_variable_any queued_;
+    std::array<Asset, assets::soundCount> assets_;
+    std::deque<Asset *> queue_;
+    std::vector<std::jthread> workers_;
+};
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include <AL/al.h>
+#include <vorbis/vorbisfile.h>
+
+#include "DeadlineTimer.h"
+
+/**
+ * Plays an ogg file while decoding it into a small ring of OpenAL buffers, so a track of any length takes the same
+ * memory
+ * @note a thread refills the buffers the source finished playing, it only touches the source and buffers of the stream
+ */
+class OggStream {
+public:
+    static constexpr int bufferCount{4};
+    static constexpr std::size_t bufferBytes{64 * 1024};                // about 0.37s of stereo at 44.1kHz
+    static constexpr std::chrono::milliseconds refillPeriod{100};
+
+    /**
+     * Starts playing a file
+     * @param oggFile the path of the file
+     * @param loop whether to start over at the end without a gap, until the stream is destroyed
+     * @throws std::runtime_error if the file can't be decoded or the source can't be created
+     */
+    OggStream(const std::string &oggFile, bool loop) noexcept(false);
+
+    OggStream(const OggStream &) = delete;
+
+    OggStream &operator=(const OggStream &) = delete;
+
+    /**
+     * Stops playing and releases the source and the buffers
+     */
+    ~OggStream();
+
+    /**
+     * Checks whether a stream that doesn't loop played to its end
+     */
+    [[nodiscard]] bool finished() const;
+
+private:
+    /**
+     * Decodes the next samples into the decoding buffer, starting over at the end of a looping file
+     * @return the number of bytes decoded, 0 at the end of the file
+     */
+    std::size_t decode();
+
+    /**
+     * Refills the processed buffers and queues them again until the end or until stopped
+     */
+    void refill(const std::stop_token &stop);
+
+    OggVorbis_File vorbisFile_{};
+    ALenum format_;
+    ALsizei sampleRate_;
+    bool loop_;
+    ALuint source_ = 0;
+    ALuint buffers_[bufferCount]{};
+    std::vector<char> pcm_ = std::vector<char>(bufferBytes);
+    DeadlineTimer timer_{DeadlineTimer::Clock::MONOTONIC};
+    std::atomic<bool> finished_{false};
+    std::jthread thread_;
+};
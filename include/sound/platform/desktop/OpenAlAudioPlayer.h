@@ -1,10 +1,17 @@
 #pragma once
 
+#include <array>
+#include <memory>
 #include <iostream>
 #include <AL/al.h>
 #include <AL/alc.h>
 #include <unordered_map>
 
+#include "sound/Assets.h"
+#include "sound/platform/desktop/PcmCache.h"
+#include "sound/platform/desktop/AssetLoader.h"
+#include "sound/platform/desktop/OggStream.h"
+
 class OpenAlAudioPlayer {
 public:
     OpenAlAudioPlayer();
@@ -12,18 +19,49 @@ public:
     ~OpenAlAudioPlayer();
 
     /**
-     * Loads an audio file
+     * Loads a sound without waiting for it, the ogg files are decoded in parallel and kept decoded in the cache
+     * directory
+     * @note called from the thread that plays the sounds, which owns the audio context
+     * @param lazy whether to defer decoding an ogg file until it's played first
+     */
+    void load(SoundId, bool lazy = false);
+
+    /**
+     * Plays a sound, waiting only for the decoding of this sound if it's the first time, a sound that wasn't loaded
+     * is ignored
+     * @note called from the thread that loads the sounds, the samples are uploaded to OpenAL on the first play
      */
-    void load(const std::string &);
+    void play(SoundId) noexcept(true);
 
     /**
-     * Plays an audio file
+     * Plays an ogg file while decoding it, restarting it if it's playing already, for tracks too long to be loaded
+     * @param loop whether to start over at the end until stopped
+     * @throws std::runtime_error if the file can't be decoded
      */
-    void play(const std::string &) const noexcept(true);
+    void stream(const std::string &, bool loop) noexcept(false);
+
+    /**
+     * Stops a streamed file, if it's playing
+     */
+    void stop(const std::string &);
 
 private:
+    struct Sound {
+        ALuint source = 0;  // 0 until the samples are uploaded
+        bool loaded = false;
+        bool failed = false;
+    };
+
+    /**
+     * Creates a source playing a buffer of samples
+     */
+    ALuint upload(ALenum format, const ALvoid *samples, ALsizei size, ALsizei sampleRate);
+
     ALCdevice *openALDevice_ = nullptr;
     ALCcontext *openALContext_ = nullptr;
     ALCboolean contextCurrent_ = false;
-    std::unordered_map<std::string, ALuint> audio_;
+    std::array<Sound, assets::soundCount> audio_;
+    std::unordered_map<std::string, std::unique_ptr<OggStream>> streams_;
+    PcmCache cache_;
+    AssetLoader loader_;    // after the cache it loads through
 };
\ No newline at end of file
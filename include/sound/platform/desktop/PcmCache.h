@@ -0,0 +1,85 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <filesystem>
+#include <vorbis/vorbisfile.h>
+
+#include "utils.h"
+
+/**
+ * Keeps the decoded samples of the ogg assets in the cache directory, so that only the first start decodes them and
+ * the later ones map the samples straight from the cache
+ * @note an entry is keyed by the path, mtime and size of the asset, a changed asset is decoded again
+ */
+class PcmCache {
+public:
+    /**
+     * Signed 16 bits little endian samples, interleaved
+     */
+    class Sound {
+    public:
+        unsigned int channels = 0;
+        unsigned int sampleRate = 0;
+
+        /**
+         * Get the samples
+         * @return a view that is valid as long as this object lives
+         */
+        [[nodiscard]] std::string_view samples() const;
+
+    private:
+        friend class PcmCache;
+
+        std::unique_ptr<utils::MappedFile> mapping_;    // the cache entry, or nullptr if decoded in memory
+        std::size_t offset_ = 0;                        // of the samples in the mapping
+        std::vector<char> decoded_;
+    };
+
+    /**
+     * @param directory the directory the entries are kept in, nothing is persisted if it's empty
+     */
+    explicit PcmCache(std::filesystem::path directory);
+
+    /**
+     * Get the samples of an ogg file, from the cache if the file didn't change since it was decoded
+     * @param oggFile the path of the ogg file
+     * @throws std::runtime_error if the file can't be read or decoded
+     */
+    Sound load(const std::string &oggFile) noexcept(false);
+
+    /**
+     * Decodes an ogg file into memory
+     * @param oggFile the path of the ogg file
+     * @throws std::runtime_error if the file can't be read or decoded
+     */
+    static Sound decode(const std::string &oggFile) noexcept(false);
+
+    /**
+     * Decodes an ogg stream held in memory
+     * @param ogg the bytes of the stream
+     * @param name what the errors call the stream
+     * @throws std::runtime_error if the stream can't be decoded
+     */
+    static Sound decodeMemory(std::string_view ogg, const std::string &name) noexcept(false);
+
+private:
+    /**
+     * Decodes an opened vorbis file and clears it
+     */
+    static Sound decode(OggVorbis_File &vorbisFile, const std::string &name) noexcept(false);
+
+    [[nodiscard]] std::filesystem::path entry(const std::string &oggFile) const;
+
+    static std::optional<Sound> read(const std::filesystem::path &entry, const std::string &oggFile, int64_t mtime,
+                                     uint64_t size);
+
+    static void write(const std::filesystem::path &entry, const std::string &oggFile, int64_t mtime, uint64_t size,
+                      const Sound &sound);
+
+    std::filesystem::path directory_;
+};
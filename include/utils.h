@@ -1,9 +1,16 @@
 #pragma once
 
-#include <deque>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <cstdint>
+#include <string_view>
 #include <vector>
-#include <mutex>
-#include <condition_variable>
+#include <optional>
+#include <functional>
+#include <filesystem>
+#include <sys/types.h>
 
 #ifndef __ANDROID__
 
@@ -15,179 +22,254 @@
 
 namespace utils {
     namespace concurrent {
+        namespace detail {
+            /**
+             * Waits until a word no longer holds a value, a timeout or a spurious wakeup
+             * @note C++20 has no timed atomic wait, this is a futex wait on the word
+             */
+            void waitFor(const std::atomic<uint32_t> &word, uint32_t old, std::chrono::nanoseconds timeout);
+
+            /**
+             * Wakes every thread blocked in waitFor on a word
+             */
+            void wakeAll(const std::atomic<uint32_t> &word);
+        }
+
         /**
-         * A threadsafe queue inspired from the STL
+         * A bounded lock-free queue for many producers and a single consumer
+         * @note pushing never takes a lock, try_push is async-signal-safe as long as constructing Tp is
          * @tparam Tp Type of element.
-         * @tparam Sequence Type of underlying sequence, defaults to deque_Tp>
-         * @tparam Mutex Type of mutex used to synchronize operations
+         * @tparam Capacity The number of elements the ring holds, a power of two
          */
-        template<typename Tp, typename Sequence = std::deque<Tp>, typename Mutex = std::mutex>
-        class queue {
-            template<typename Tp1, typename Seq1>
-            friend bool operator==(const queue<Tp1, Seq1> &, const queue<Tp1, Seq1> &);
-
-            template<typename Tp1, typename Seq1>
-            friend bool operator<(const queue<Tp1, Seq1> &, const queue<Tp1, Seq1> &);
-
-#ifdef __cpp_lib_three_way_comparison
-
-            template<typename Tp1, std::three_way_comparable Seq1>
-            friend std::compare_three_way_result_t<Seq1>
-            operator<=>(const queue<Tp1, Seq1> &, const queue<Tp1, Seq1> &);
-
-#endif
-            template<typename Alloc> using Uses = typename std::enable_if<std::uses_allocator<Sequence, Alloc>::value>::type;
-
-
-            static_assert(std::is_same<Tp, typename Sequence::value_type>::value,
-                          "value_type must be the same as the underlying container");
+        template<typename Tp, std::size_t Capacity = 256>
+        class ring {
+            static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
 
         public:
-            typedef typename Sequence::value_type value_type;
-            typedef typename Sequence::reference reference;
-            typedef typename Sequence::const_reference const_reference;
-            typedef typename Sequence::size_type size_type;
-            typedef Sequence container_type;
+            typedef Tp value_type;
 
-        private:
-            Sequence c_;
-            mutable Mutex m_;
-            std::condition_variable cv_;
-
-        public:
-            template<typename Seq = Sequence, typename = typename std::enable_if<std::is_default_constructible<Seq>::value>::type>
-            queue() : c_() {}
-
-            explicit queue(const Sequence &_c) : c_(_c) {}
-
-            explicit queue(Sequence &&_c) : c_(std::move(_c)) {}
+            ring() {
+                for (auto i{0u}; i < Capacity; ++i) slots_[i].sequence.store(i, std::memory_order_relaxed);
+            }
 
-            template<typename Alloc, typename = Uses<Alloc>>
-            explicit queue(const Alloc &_a) : c_(_a) {}
+            ring(const ring &) = delete;
 
-            template<typename Alloc, typename = Uses<Alloc>>
-            queue(Sequence &&_c, const Alloc &_a) : c_(std::move(_c), _a) {}
+            ring &operator=(const ring &) = delete;
 
-            template<typename Alloc, typename = Uses<Alloc>>
-            queue(const queue &_q, const Alloc &_a) {
-                std::scoped_lock(m_, _q.m_);
-                c_(_q.c_, _a);
+            ~ring() {
+                while (try_pop()) {}
             }
 
-            template<typename Alloc, typename = Uses<Alloc>>
-            queue(queue &&_q, const Alloc &_a) {
-                std::scoped_lock(m_, _q.m_);
-                c_(std::move(_q.c_), _a);
-            }
+            /**
+             * Pushes an element unless the ring is full or closed, nothing is moved from _x if it fails
+             * @return true if the element was pushed
+             */
+            template<typename Up>
+            bool try_push(Up &&_x) {
+                if (closed_.load(std::memory_order_acquire)) return false;
+
+                // a slot is free for the push at pos once its sequence caught up with pos
+                auto pos{tail_.load(std::memory_order_relaxed)};
+                Slot *slot;
+                while (true) {
+                    slot = &slots_[pos & (Capacity - 1)];
+                    auto sequence{slot->sequence.load(std::memory_order_acquire)};
+                    auto diff{static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(pos)};
+                    if (diff == 0) {
+                        if (tail_.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) break;
+                    } else if (diff < 0) {
+                        return false;   // the consumer hasn't popped the element Capacity pushes ago
+                    } else {
+                        pos = tail_.load(std::memory_order_relaxed);
+                    }
+                }
 
-            bool empty() const {
-                std::lock_guard lk(m_);
-                return c_.empty();
+                new(slot->storage) Tp(std::forward<Up>(_x));
+                slot->sequence.store(pos + 1, std::memory_order_release);
+
+                // pairs with the fence in sleep(), either the consumer sees the element or we see it sleeping
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                // only the first push after the consumer went to sleep pays for waking it up
+                if (consumerSleeping_.load(std::memory_order_relaxed) == Sleep::AWAKE) return true;
+                if (auto sleeping{consumerSleeping_.exchange(Sleep::AWAKE)}; sleeping != Sleep::AWAKE) {
+                    pushes_.fetch_add(1, std::memory_order_relaxed);
+                    if (sleeping == Sleep::WAIT) pushes_.notify_one();
+                    else detail::wakeAll(pushes_);
+                }
+                return true;
             }
 
-            size_type size() const {
-                std::lock_guard lk(m_);
-                return c_.size();
-            }
+            /**
+             * Pushes an element, waiting for the consumer while the ring is full
+             * @return false if the ring is closed
+             */
+            template<typename Up>
+            bool push(Up &&_x) {
+                for (auto spins{0u}; spins < spinLimit; ++spins) {
+                    if (try_push(std::forward<Up>(_x))) return true;
+                    if (closed_.load(std::memory_order_acquire)) return false;
+                }
 
-            void push(const value_type &_x) {
-                {
-                    std::lock_guard lk(m_);
-                    c_.push_back(_x);
+                blockedProducers_.fetch_add(1);
+                bool pushed;
+                while (true) {
+                    auto pops{pops_.load()};
+                    if ((pushed = try_push(std::forward<Up>(_x))) || closed_.load(std::memory_order_acquire)) break;
+                    pops_.wait(pops);
                 }
-                cv_.notify_one();
+                blockedProducers_.fetch_sub(1);
+                return pushed;
             }
 
-            void push(value_type &&_x) {
-                {
-                    std::lock_guard lk(m_);
-                    c_.push_back(std::move(_x));
+            /**
+             * Pops the oldest element if there is one
+             * @note only the consumer may pop
+             */
+            std::optional<Tp> try_pop() {
+                auto &slot{slots_[head_ & (Capacity - 1)]};
+                if (slot.sequence.load(std::memory_order_acquire) != head_ + 1) return std::nullopt;
+
+                auto element{reinterpret_cast<Tp *>(slot.storage)};
+                std::optional<Tp> value{std::move(*element)};
+                element->~Tp();
+                slot.sequence.store(head_ + Capacity, std::memory_order_release);
+
+                // producers blocked on a full ring are woken once a quarter of it is free, not for every slot
+                if (++head_ % quarter == 0) {
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    if (blockedProducers_.load(std::memory_order_relaxed) != 0) {
+                        pops_.fetch_add(1, std::memory_order_relaxed);
+                        pops_.notify_all();
+                    }
                 }
-                cv_.notify_one();
+                return value;
             }
 
-            reference wait_pop() {
-                std::unique_lock lk(m_);
-                cv_.wait(lk, [&] { return !c_.empty(); });
-                reference elem = c_.front();
-                c_.pop_front();
-                return elem;
+            /**
+             * Pops every element that is ready
+             * @param consumer called with each element, oldest first
+             * @return the number of popped elements
+             */
+            template<typename Consumer>
+            std::size_t drain(Consumer &&consumer) {
+                std::size_t count{0};
+                for (auto value{try_pop()}; value; value = try_pop(), ++count) consumer(std::move(*value));
+                return count;
             }
 
-            void swap(queue &_q) noexcept(std::__is_nothrow_swappable<Sequence>::value) {
-                using std::swap;
-                std::scoped_lock(m_, _q.m_);
-                swap(c_, _q.c_);
+            /**
+             * Pops the oldest element, waiting for one to be pushed
+             * @return the element, or nothing once the ring is closed and empty
+             */
+            std::optional<Tp> wait_pop() {
+                return sleep(Sleep::WAIT, [this](uint32_t pushes) {
+                    pushes_.wait(pushes, std::memory_order_relaxed);
+                    return true;
+                });
             }
-        };
-
-        template<typename Tp, typename Seq>
-        inline bool operator==(const queue<Tp, Seq> &_x, const queue<Tp, Seq> &_y) {
-            std::scoped_lock(_x.m_, _y.m_);
-            return _x.c_ == _y.c_;
-        }
-
-        template<typename Tp, typename Seq>
-        inline bool operator<(const queue<Tp, Seq> &_x, const queue<Tp, Seq> &_y) {
-            std::scoped_lock(_x.m_, _y.m_);
-            return _x.c_ < _y.c_;
-        }
-
-        template<typename Tp, typename Seq>
-        inline bool operator!=(const queue<Tp, Seq> &_x, const queue<Tp, Seq> &_y) { return !(_x == _y); }
-
-        template<typename Tp, typename Seq>
-        inline bool operator>(const queue<Tp, Seq> &_x, const queue<Tp, Seq> &_y) { return _y < _x; }
 
-        template<typename Tp, typename Seq>
-        inline bool operator<=(const queue<Tp, Seq> &_x, const queue<Tp, Seq> &_y) { return !(_y < _x); }
+            /**
+             * Pops the oldest element, waiting at most a timeout for one to be pushed
+             * @return the element, or nothing if the timeout passed or the ring is closed and empty
+             */
+            template<typename Rep, typename Period>
+            std::optional<Tp> wait_pop_for(const std::chrono::duration<Rep, Period> &timeout) {
+                auto deadline{std::chrono::steady_clock::now() + timeout};
+                return sleep(Sleep::FUTEX, [this, deadline](uint32_t pushes) {
+                    auto remaining{deadline - std::chrono::steady_clock::now()};
+                    if (remaining <= remaining.zero()) return false;
+                    detail::waitFor(pushes_, pushes, remaining);
+                    return true;
+                });
+            }
 
-        template<typename Tp, typename Seq>
-        inline bool operator>=(const queue<Tp, Seq> &_x, const queue<Tp, Seq> &_y) { return !(_x < _y); }
+            /**
+             * Makes every following push fail and wakes the waiting threads, the elements already pushed can still
+             * be popped
+             */
+            void close() {
+                closed_.store(true);
+                pushes_.fetch_add(1);
+                pushes_.notify_all();
+                detail::wakeAll(pushes_);
+                pops_.fetch_add(1);
+                pops_.notify_all();
+            }
 
-#if __cpp_lib_three_way_comparison
+            [[nodiscard]] bool closed() const {
+                return closed_.load(std::memory_order_acquire);
+            }
 
-        template<typename Tp, std::three_way_comparable Seq>
-        inline std::compare_three_way_result_t<Seq> operator<=>(const queue<Tp, Seq> &_x, const queue<Tp, Seq> &_y) {
-            std::scoped_lock(_x.m_, _y.m_);
-            return _x.c_ <=> _y.c_;
-        }
+        private:
+            static constexpr auto spinLimit{64u};
+            static constexpr std::size_t quarter{Capacity < 4 ? 1 : Capacity / 4};
+
+            enum class Sleep : uint8_t {
+                AWAKE, WAIT, FUTEX  // how producers wake the consumer up, atomic::notify or a raw futex wake
+            };
+
+            /**
+             * Pops the oldest element, blocking in wait until one is pushed
+             * @param how The way wait blocks
+             * @param wait blocks while pushes_ holds the value it's passed, returns false to give up
+             */
+            template<typename Wait>
+            std::optional<Tp> sleep(Sleep how, Wait wait) {
+                for (auto spins{0u}; spins < spinLimit; ++spins) {
+                    if (auto value{try_pop()}; value) return value;
+                }
 
-#endif
+                std::optional<Tp> value;
+                while (true) {
+                    consumerSleeping_.store(how, std::memory_order_relaxed);
+                    auto pushes{pushes_.load(std::memory_order_relaxed)};
+                    std::atomic_thread_fence(std::memory_order_seq_cst);
+                    if ((value = try_pop()) || closed_.load(std::memory_order_acquire) || !wait(pushes)) break;
+                }
+                consumerSleeping_.store(Sleep::AWAKE, std::memory_order_relaxed);
+                return value ? value : try_pop();
+            }
 
-        template<typename Tp, typename Seq>
-        inline typename std::enable_if<std::__is_swappable<Seq>::value>::type
-        swap(queue<Tp, Seq> &_x, queue<Tp, Seq> &_y) noexcept(noexcept(_x.swap(_y))) { _x.swap(_y); }
+            struct Slot {
+                std::atomic<std::size_t> sequence;
+                alignas(Tp) unsigned char storage[sizeof(Tp)];
+            };
+
+            Slot slots_[Capacity];
+            alignas(64) std::atomic<std::size_t> tail_{0};  // the next push, shared by the producers
+            alignas(64) std::size_t head_{0};               // the next pop, owned by the consumer
+
+            /* counters the waiting threads block on, only bumped when someone is blocked on them */
+            alignas(64) std::atomic<uint32_t> pushes_{0};
+            std::atomic<Sleep> consumerSleeping_{Sleep::AWAKE};
+            alignas(64) std::atomic<uint32_t> pops_{0};
+            std::atomic<uint32_t> blockedProducers_{0};
+            std::atomic<bool> closed_{false};
+        };
     }
 
     /**
-     * Reader for .wav files
+     * A read-only memory mapping of a whole file
      */
-    class WavReader {
+    class MappedFile {
     public:
-        static std::unique_ptr<char>
-        loadWAV(const std::string &audioFile, unsigned int &chan, unsigned int &sampleRate, unsigned int &bps,
-                unsigned int &size);
+        explicit MappedFile(const std::string &path) noexcept(false);
+
+        MappedFile(const MappedFile &) = delete;
+
+        MappedFile &operator=(const MappedFile &) = delete;
+
+        ~MappedFile();
+
+        /**
+         * Get the contents of the file
+         * @return a view that is valid as long as this object lives
+         */
+        [[nodiscard]] std::string_view view() const;
 
     private:
-        struct WavHeader {
-            /* RIFF Chunk Descriptor */
-            [[maybe_unused]] uint8_t riff[4];
-            [[maybe_unused]] uint32_t chunkSize;
-            [[maybe_unused]] uint8_t waveHeader[4];
-            /* "fmt" sub-chunk */
-            [[maybe_unused]] uint8_t fmt[4];
-            [[maybe_unused]] uint32_t subChunk1Size;
-            [[maybe_unused]] uint16_t audioFormat;
-            [[maybe_unused]] uint16_t numOfChan;
-            [[maybe_unused]] uint32_t samplesPerSec;
-            [[maybe_unused]] uint32_t bytesPerSec;
-            [[maybe_unused]] uint16_t blockAlign;
-            [[maybe_unused]] uint16_t bitsPerSample;
-            /* "data" sub-chunk */
-            [[maybe_unused]] uint8_t subChunk2ID[4];
-            [[maybe_unused]] uint32_t subChunk2Size;
-        };
+        void *data_ = nullptr;
+        std::size_t size_ = 0;
     };
 
     struct ProcessResult {
@@ -195,23 +277,95 @@ namespace utils {
         std::string output;
     };
 
+    /**
+     * A process that runs while the caller multiplexes its output and its exit with other events
+     * @note the process is killed and reaped on destruction if it's still running
+     */
+    class ChildProcess {
+    public:
+        /**
+         * Spawns a process the way executeProcess does, without waiting for it
+         * @param path The path to the executable
+         * @param args The arguments to path to the executable
+         */
+        ChildProcess(const std::string &path, const std::vector<const char *> &args) noexcept(false);
+
+        ChildProcess(const ChildProcess &) = delete;
+
+        ChildProcess &operator=(const ChildProcess &) = delete;
+
+        ~ChildProcess();
+
+        /**
+         * Get the non-blocking read end of the pipe of stdout and stderr
+         */
+        [[nodiscard]] int outputFd() const;
+
+        /**
+         * Get the pidfd that becomes readable when the process exits
+         * @return the pidfd or -1 if the kernel doesn't support it
+         */
+        [[nodiscard]] int pidFd() const;
+
+        /**
+         * Reads the output that is available
+         * @param output the output is appended to it
+         * @return false once the output is closed
+         */
+        bool read(std::string &output);
+
+        /**
+         * Reaps the process, waiting for it if it's still running
+         * @return the wait status of the process
+         */
+        int wait();
+
+        /**
+         * Kills the process and reaps it
+         */
+        void kill();
+
+    private:
+        pid_t pid_;
+        int outputFd_ = -1;
+        int pidFd_ = -1;
+        bool reaped_ = false;
+        int status_ = 0;
+    };
+
     /**
      * Executes a process and returns stdout or stderr as string
+     * @note the process is started with posix_spawn, path is passed as argv[0]
      * @param path The path to the executable
      * @param args The arguments to path to the executable
+     * @param timeout The time after which the process is killed and std::runtime_error is thrown
      * @return ProcessResult struct containing the output and the exit code
      */
-    ProcessResult executeProcess(const std::string &path, const std::vector<const char *> &args) noexcept(false);
+    ProcessResult executeProcess(const std::string &path, const std::vector<const char *> &args,
+                                 std::chrono::milliseconds timeout = std::chrono::seconds(10)) noexcept(false);
+
+    /**
+     * Executes a process and streams its stdout and stderr instead of collecting them
+     * @param path The path to the executable
+     * @param args The arguments to path to the executable
+     * @param sink Called with each chunk of output as soon as it's read, exceptions it throws kill the process
+     * @param timeout The time after which the process is killed and std::runtime_error is thrown
+     * @return ProcessResult struct containing the exit code, the output is left empty
+     */
+    ProcessResult executeProcess(const std::string &path, const std::vector<const char *> &args,
+                                 const std::function<void(std::string_view)> &sink,
+                                 std::chrono::milliseconds timeout = std::chrono::seconds(10)) noexcept(false);
 
     /**
-     * Formats the stdout of timew commands
-     * @param description The string returned from execute process
-     * @return The new formatted string
+     * Gets the directory for the cached files of this program ($XDG_CACHE_HOME/tw-pomodoro or ~/.cache/tw-pomodoro)
+     * @note the directory is created if it doesn't exist
+     * @return the path to the directory or an empty path if it can't be created
      */
-    std::string formatDescription(const std::string &description);
+    std::filesystem::path cacheDirectory();
 
     /**
      * Converts std::string to std::wstring
+     * @note malformed UTF-8 sequences become U+FFFD instead of throwing
      * @param string To be converted to std::wstring
      * @return std::wstring
      */
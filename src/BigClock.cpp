@@ -0,0 +1,51 @@
+#include "BigClock.h"
+
+BigClock::BigClock(const Ncurses::Screen &screen) : screen_(screen) {}
+
+int BigClock::fit(int lines, int cols) {
+    font_ = nullptr;
+    for (const auto &font: utils::glyphs::fonts) {
+        if (font.height <= lines && utils::glyphs::width(font, "00:00:00") <= cols) font_ = &font;
+    }
+    invalidate();
+    return font_ ? font_->height : 1;
+}
+
+void BigClock::draw(const std::string &text, int y) {
+    if (font_ == nullptr) {
+        screen_.putCentered(text, y, static_cast<int>(text.size()));
+        return;
+    }
+
+    // the glyphs only stay in place if the text keeps its length and its colons
+    auto full{y != shownY_ || text.size() != shown_.size()};
+    for (std::size_t i{0}; !full && i < text.size(); ++i) full = (text[i] == ':') != (shown_[i] == ':');
+    if (full) {
+        for (auto line{y}; line < y + font_->height; ++line) screen_.putAt("", line, 0);
+    }
+
+    auto x{(screen_.getCols() - utils::glyphs::width(*font_, text)) / 2};
+    std::string row;
+    for (std::size_t i{0}; i < text.size(); ++i) {
+        auto glyph{utils::glyphs::glyph(*font_, text[i])};
+        auto width{glyph ? glyph->width : font_->scaleX * 3};
+
+        if (full || text[i] != shown_[i]) {
+            for (auto r{0}; r < font_->height; ++r) {
+                row.clear();
+                for (auto col{width - 1}; col >= 0; --col)
+                    row.push_back(glyph && (glyph->rows[r] >> col & 1u) ? '#' : ' ');
+                screen_.putBitmap(row, y + r, x);
+            }
+        }
+        x += width + font_->gap;
+    }
+
+    shown_ = text;
+    shownY_ = y;
+}
+
+void BigClock::invalidate() {
+    shown_.clear();
+    shownY_ = -1;
+}
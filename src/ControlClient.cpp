@@ -0,0 +1,76 @@
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <poll.h>
+#include <unistd.h>
+#include <stdexcept>
+#include <sys/un.h>
+#include <sys/socket.h>
+
+#include "config.h"
+#include "ControlSocket.h"
+
+// the client side of the control socket, linked into the client and the hook without the event loop
+
+static constexpr std::string_view commandNames[]{"start", "continue", "pause", "status", "quit"};
+
+std::string ControlSocket::defaultPath() {
+    if (auto runtimeDirectory{std::getenv("XDG_RUNTIME_DIR")}; runtimeDirectory && *runtimeDirectory)
+        return std::string(runtimeDirectory) + "/" PROJECT_NAME ".sock";
+    auto temporaryDirectory{std::getenv("TMPDIR")};
+    return std::string(temporaryDirectory && *temporaryDirectory ? temporaryDirectory : "/tmp") +
+           "/" PROJECT_NAME "-" + std::to_string(getuid()) + ".sock";
+}
+
+std::optional<ControlCommand> ControlSocket::parse(std::string_view datagram) {
+    auto first{datagram.find_first_not_of(" \t\r\n")};
+    if (first == std::string_view::npos) return std::nullopt;
+    datagram = datagram.substr(first, datagram.find_last_not_of(" \t\r\n") - first + 1);
+
+    for (std::size_t i{0}; i < std::size(commandNames); ++i) {
+        if (datagram == commandNames[i]) return static_cast<ControlCommand>(i);
+    }
+    return std::nullopt;
+}
+
+std::string ControlSocket::send(const std::string &path, std::string_view command, std::chrono::milliseconds timeout) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path.size() >= sizeof(address.sun_path)) throw std::runtime_error("The socket path is too long: " + path);
+    std::memcpy(address.sun_path, path.c_str(), path.size() + 1);
+
+    auto fd{socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0)};
+    if (fd == -1) throw std::runtime_error("Failed to create a socket");
+
+    // an address of only the family autobinds an abstract address the reply is sent to
+    sockaddr_un self{};
+    self.sun_family = AF_UNIX;
+    if (timeout.count() > 0 && bind(fd, reinterpret_cast<sockaddr *>(&self), sizeof(sa_family_t)) == -1) {
+        close(fd);
+        throw std::runtime_error("Failed to bind a socket for the reply");
+    }
+
+    if (sendto(fd, command.data(), command.size(), 0, reinterpret_cast<sockaddr *>(&address), sizeof(address)) ==
+        -1) {
+        auto error{errno};
+        close(fd);
+        throw std::runtime_error(error == ENOENT || error == ECONNREFUSED ? "No " PROJECT_NAME " is running"
+                                                                           : "Failed to send to " + path);
+    }
+
+    std::string reply;
+    if (timeout.count() > 0) {
+        pollfd events{fd, POLLIN, 0};
+        char buffer[1024];
+        ssize_t size{-1};
+        if (poll(&events, 1, static_cast<int>(timeout.count())) == 1)
+            size = recv(fd, buffer, sizeof(buffer), 0);
+        if (size == -1) {
+            close(fd);
+            throw std::runtime_error("No reply from " PROJECT_NAME);
+        }
+        reply.assign(buffer, size);
+    }
+    close(fd);
+    return reply;
+}
@@ -0,0 +1,78 @@
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <stdexcept>
+#include <sys/un.h>
+#include <sys/stat.h>
+#include <sys/socket.h>
+
+#include "ControlSocket.h"
+
+/**
+ * Checks whether a process still receives on a socket path, connecting to a socket nobody holds is refused
+ */
+static bool isListening(const sockaddr_un &address) {
+    auto probe{socket(AF_UNIX, SOCK_DGRAM | SOCK_CLOEXEC, 0)};
+    if (probe == -1) return true;
+    auto listening{connect(probe, reinterpret_cast<const sockaddr *>(&address), sizeof(address)) == 0 ||
+                   errno != ECONNREFUSED};
+    close(probe);
+    return listening;
+}
+
+ControlSocket::ControlSocket(EventLoop &loop, std::string path, Handler handler)
+        : loop_(loop), path_(std::move(path)), handler_(std::move(handler)) {
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    if (path_.size() >= sizeof(address.sun_path)) throw std::runtime_error("The socket path is too long: " + path_);
+    std::memcpy(address.sun_path, path_.c_str(), path_.size() + 1);
+
+    fd_ = socket(AF_UNIX, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd_ == -1) throw std::runtime_error("Failed to create the control socket");
+
+    auto bound{bind(fd_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0};
+    // the socket file outlives a process that crashed
+    if (!bound && errno == EADDRINUSE && !isListening(address)) {
+        unlink(path_.c_str());
+        bound = bind(fd_, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == 0;
+    }
+    if (!bound) {
+        auto inUse{errno == EADDRINUSE};
+        close(fd_);
+        throw std::runtime_error(inUse ? "Another process listens on " + path_ : "Failed to bind " + path_);
+    }
+    // only the user sends commands, $XDG_RUNTIME_DIR is private already but /tmp isn't
+    chmod(path_.c_str(), S_IRUSR | S_IWUSR);
+
+    try {
+        loop_.watch(fd_, EPOLLIN, [this](uint32_t) { read(); });
+    } catch (...) {
+        close(fd_);
+        unlink(path_.c_str());
+        throw;
+    }
+}
+
+ControlSocket::~ControlSocket() {
+    loop_.unwatch(fd_);
+    close(fd_);
+    unlink(path_.c_str());
+}
+
+void ControlSocket::read() {
+    char buffer[256];
+    sockaddr_un sender{};
+    socklen_t senderSize{sizeof(sender)};
+
+    ssize_t size;
+    while ((size = recvfrom(fd_, buffer, sizeof(buffer), 0, reinterpret_cast<sockaddr *>(&sender), &senderSize)) >=
+           0) {
+        auto command{parse({buffer, static_cast<std::size_t>(size)})};
+        auto reply{command ? handler_(*command) : "error: unknown command"};
+
+        // an unbound sender has an address of only the family and waits for nothing
+        if (senderSize > sizeof(sa_family_t))
+            sendto(fd_, reply.data(), reply.size(), MSG_DONTWAIT, reinterpret_cast<sockaddr *>(&sender), senderSize);
+        senderSize = sizeof(sender);
+    }
+}
@@ -0,0 +1,83 @@
+#include <ctime>
+#include <cerrno>
+#include <poll.h>
+#include <cstdint>
+#include <algorithm>
+#include <unistd.h>
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+
+#include "DeadlineTimer.h"
+
+DeadlineTimer::DeadlineTimer(Clock clock) : clockId_(clock == Clock::BOOTTIME ? CLOCK_BOOTTIME : CLOCK_MONOTONIC) {
+    timerFd_ = timerfd_create(clockId_, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (timerFd_ == -1) throw std::runtime_error("Failed to create timerfd");
+
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd_ == -1) {
+        close(timerFd_);
+        throw std::runtime_error("Failed to create eventfd");
+    }
+}
+
+DeadlineTimer::~DeadlineTimer() {
+    close(wakeFd_);
+    close(timerFd_);
+}
+
+std::chrono::nanoseconds DeadlineTimer::now() const {
+    timespec time{};
+    clock_gettime(clockId_, &time);
+    return std::chrono::seconds(time.tv_sec) + std::chrono::nanoseconds(time.tv_nsec);
+}
+
+int DeadlineTimer::fd() const {
+    return timerFd_;
+}
+
+void DeadlineTimer::arm(std::chrono::nanoseconds deadline) {
+    // a zero it_value disarms the timer
+    deadline = std::max(deadline, std::chrono::nanoseconds(1));
+    itimerspec spec{{0, 0},
+                    {static_cast<time_t>(deadline.count() / 1000000000),
+                     static_cast<long>(deadline.count() % 1000000000)}};
+    if (timerfd_settime(timerFd_, TFD_TIMER_ABSTIME, &spec, nullptr) == -1)
+        throw std::runtime_error("Failed to arm timerfd");
+}
+
+void DeadlineTimer::disarm() {
+    itimerspec spec{};
+    timerfd_settime(timerFd_, 0, &spec, nullptr);
+}
+
+bool DeadlineTimer::expired() {
+    // nothing is read if the timer was rearmed since it became readable
+    uint64_t value;
+    return read(timerFd_, &value, sizeof(value)) == sizeof(value);
+}
+
+bool DeadlineTimer::waitUntil(std::chrono::nanoseconds deadline) {
+    arm(deadline);
+
+    while (true) {
+        pollfd fds[2]{{timerFd_, POLLIN, 0},
+                      {wakeFd_,  POLLIN, 0}};
+        if (poll(fds, 2, -1) == -1) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("Failed to wait for timerfd");
+        }
+
+        if (fds[1].revents != 0) {
+            uint64_t value;
+            [[maybe_unused]] auto read_{read(wakeFd_, &value, sizeof(value))};
+            return false;
+        }
+        if (expired()) return true;
+    }
+}
+
+void DeadlineTimer::wake() const {
+    uint64_t value{1};
+    [[maybe_unused]] auto written{write(wakeFd_, &value, sizeof(value))};
+}
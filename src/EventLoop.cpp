@@ -0,0 +1,131 @@
+#include <cerrno>
+#include <csignal>
+#include <unistd.h>
+#include <stdexcept>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+
+#include "EventLoop.h"
+
+EventLoop::EventLoop() {
+    epollFd_ = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd_ == -1) throw std::runtime_error("Failed to create epoll instance");
+
+    wakeFd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd_ == -1) {
+        close(epollFd_);
+        throw std::runtime_error("Failed to create eventfd");
+    }
+
+    try {
+        watch(wakeFd_, EPOLLIN, [this](uint32_t) {
+            uint64_t value;
+            [[maybe_unused]] auto read_{read(wakeFd_, &value, sizeof(value))};
+        });
+    } catch (...) {
+        close(wakeFd_);
+        close(epollFd_);
+        throw;
+    }
+}
+
+EventLoop::~EventLoop() {
+    posted_.close();
+    if (signalFd_ != -1) close(signalFd_);
+    close(wakeFd_);
+    close(epollFd_);
+}
+
+void EventLoop::watch(int fd, uint32_t events, Handler handler) {
+    auto generation{++generation_};
+    epoll_event event{events, {.u64 = static_cast<uint64_t>(generation) << 32 | static_cast<uint32_t>(fd)}};
+    if (epoll_ctl(epollFd_, EPOLL_CTL_ADD, fd, &event) == -1) throw std::runtime_error("Failed to watch fd");
+    watches_[fd] = {generation, std::make_shared<Handler>(std::move(handler))};
+}
+
+void EventLoop::unwatch(int fd) {
+    if (watches_.erase(fd) != 0) epoll_ctl(epollFd_, EPOLL_CTL_DEL, fd, nullptr);
+}
+
+void EventLoop::blockSignals(std::initializer_list<int> signals) {
+    sigset_t mask;
+    sigemptyset(&mask);
+    for (auto signal: signals) sigaddset(&mask, signal);
+    if (pthread_sigmask(SIG_BLOCK, &mask, nullptr) != 0) throw std::runtime_error("Failed to block signals");
+}
+
+void EventLoop::watchSignals(std::initializer_list<int> signals, std::function<void(int signal)> handler) {
+    blockSignals(signals);
+    sigset_t mask;
+    sigemptyset(&mask);
+    for (auto signal: signals) sigaddset(&mask, signal);
+
+    signalFd_ = signalfd(signalFd_, &mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (signalFd_ == -1) throw std::runtime_error("Failed to create signalfd");
+
+    unwatch(signalFd_);
+    watch(signalFd_, EPOLLIN, [this, handler = std::move(handler)](uint32_t) {
+        signalfd_siginfo info{};
+        while (read(signalFd_, &info, sizeof(info)) == sizeof(info)) handler(static_cast<int>(info.ssi_signo));
+    });
+}
+
+void EventLoop::post(std::function<void()> task) {
+    // the loop doesn't need to be woken up for its own tasks
+    if (std::this_thread::get_id() == thread_) {
+        local_.push_back(std::move(task));
+        return;
+    }
+
+    if (!posted_.push(std::move(task))) return;     // the loop is being destroyed
+    uint64_t value{1};
+    [[maybe_unused]] auto written{write(wakeFd_, &value, sizeof(value))};
+}
+
+void EventLoop::beforeWait(std::function<void()> hook) {
+    beforeWait_ = std::move(hook);
+}
+
+void EventLoop::run() {
+    epoll_event events[16];
+    running_ = true;
+
+    while (running_) {
+        if (beforeWait_) beforeWait_();
+
+        // tasks posted before run() don't wait for an event
+        auto count{epoll_wait(epollFd_, events, std::size(events), local_.empty() ? -1 : 0)};
+        if (count == -1) {
+            if (errno == EINTR) continue;
+            throw std::runtime_error("Failed to wait for events");
+        }
+
+        for (auto i{0}; i < count; ++i) {
+            auto fd{static_cast<int>(events[i].data.u64 & 0xffffffff)};
+            auto generation{static_cast<uint32_t>(events[i].data.u64 >> 32)};
+
+            // a handler may unwatch any file descriptor, including its own
+            auto watch{watches_.find(fd)};
+            if (watch == watches_.end() || watch->second.generation != generation) continue;
+            auto handler{watch->second.handler};
+            (*handler)(events[i].events);
+        }
+
+        runPosted();
+    }
+}
+
+void EventLoop::stop() {
+    running_ = false;
+}
+
+void EventLoop::runPosted() {
+    posted_.drain([this](std::function<void()> &&task) { local_.push_back(std::move(task)); });
+
+    // the tasks posted while these run wait for the next iteration
+    for (auto count{local_.size()}; running_ && count > 0; --count) {
+        auto task{std::move(local_.front())};
+        local_.pop_front();
+        task();
+    }
+}
@@ -1,6 +1,8 @@
-#include <thread>
 #include <locale>
 #include <vector>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
 
 #include <algorithm>
 
@@ -10,30 +12,79 @@
 #include "utils.h"
 #endif
 
+/* the screens in the order they are staged, bottom first */
+static std::vector<Ncurses::Screen *> screens;
+static Ncurses::FrameStats rendered;
+static int ioFd = -1;   // the io accounting of the thread that initialized ncurses, the one rendering
+
+/**
+ * Get the bytes the rendering thread passed to write() so far, ncurses writes the terminal with its own buffer so
+ * this is the only way to see how much a frame wrote
+ * @return the bytes or -1 if the kernel doesn't account them per thread
+ */
+static long long writtenBytes() {
+    if (ioFd == -1) return -1;
+    char buf[512];
+    auto size{pread(ioFd, buf, sizeof(buf) - 1, 0)};
+    if (size <= 0) return -1;
+    buf[size] = '\0';
+    auto wchar{std::strstr(buf, "wchar: ")};
+    return wchar == nullptr ? -1 : std::strtoll(wchar + 7, nullptr, 10);
+}
+
 Ncurses::Ncurses() {
     setlocale(LC_ALL, "");
     initscr();
     raw();
     noecho();
     curs_set(0);
+    ioFd = open("/proc/thread-self/io", O_RDONLY | O_CLOEXEC);
 }
 
 Ncurses::~Ncurses() {
+    if (ioFd != -1) close(ioFd);
+    ioFd = -1;
     endwin();
 }
 
-Ncurses::Screen::Screen(int height, int width, int y, int x) : lines_(height), cols_(width) {
+void Ncurses::render() {
+    // a screen staged after another one is staged again even if it didn't change, so that the one below doesn't
+    // cover it, doupdate only writes what differs from the terminal anyway
+    auto staged{false};
+    for (auto screen: screens) staged = screen->stage(staged) || staged;
+    if (!staged) return;
+
+    auto before{writtenBytes()};
+    doupdate();
+    auto after{writtenBytes()};
+
+    ++rendered.frames;
+    if (before != -1 && after >= before) {
+        rendered.lastFrameBytes = after - before;
+        rendered.bytes += rendered.lastFrameBytes;
+        rendered.maxFrameBytes = std::max(rendered.maxFrameBytes, rendered.lastFrameBytes);
+    }
+}
+
+const Ncurses::FrameStats &Ncurses::frameStats() {
+    return rendered;
+}
+
+Ncurses::Screen::Screen(int height, int width, int y, int x) : lines_(height), cols_(width), shown_(height) {
     window_ = newwin(height, width, y, x);
     if (window_ == nullptr) throw std::runtime_error("Failed to create a window");
     keypad(window_, true);
+    screens.push_back(this);
 }
 
-Ncurses::Screen::Screen(WINDOW *window) : lines_(LINES), cols_(COLS) {
+Ncurses::Screen::Screen(WINDOW *window) : lines_(LINES), cols_(COLS), shown_(LINES) {
     window_ = window;
     keypad(window_, true);
+    screens.push_back(this);
 }
 
 Ncurses::Screen::~Screen() {
+    std::erase(screens, this);
     delwin(window_);
 }
 
@@ -41,182 +92,104 @@ int Ncurses::Screen::getCharToLower() const {
     return std::tolower(wgetch(window_));
 }
 
-void Ncurses::Screen::putAt(const std::string &string, int y, int x) const {
-    if (y < 0 || y >= lines_) return;
-    wmove(window_, y, 0);
-    wclrtoeol(window_);
-    wmove(window_, y, x);
-    waddstr(window_, string.c_str());
-    wrefresh(window_);
+void Ncurses::Screen::setNonBlocking(bool nonBlocking) const {
+    nodelay(window_, nonBlocking);
 }
 
-
-void Ncurses::Screen::putAt(const std::wstring &string, int y, int x) const {
+template<typename Char>
+void Ncurses::Screen::draw(std::basic_string_view<Char> string, int y, int x) const {
     if (y < 0 || y >= lines_) return;
+
+    auto &line{shown_[y]};
+    if constexpr (std::is_same_v<Char, char>) {
+        if (line.x == x && line.wtext.empty() && line.text == string) return;
+        line.text = string;
+        line.wtext.clear();
+    } else {
+        if (line.x == x && line.text.empty() && line.wtext == string) return;
+        line.wtext = string;
+        line.text.clear();
+    }
+    line.x = x;
+
     wmove(window_, y, 0);
     wclrtoeol(window_);
     wmove(window_, y, x);
+    if constexpr (std::is_same_v<Char, char>) {
+        waddnstr(window_, string.data(), static_cast<int>(string.size()));
+    } else {
 #ifdef waddwstr
-    waddwstr(window_, string.c_str());
+        waddnwstr(window_, string.data(), static_cast<int>(string.size()));
 #else
-    waddstr(window_, utils::utfToString(string).c_str());
+        waddstr(window_, utils::utfToString(std::wstring(string)).c_str());
 #endif
-    wrefresh(window_);
+    }
+    dirty_ = true;
 }
 
-void Ncurses::Screen::putFor(const std::string &string, int y, int x, std::chrono::seconds duration) const {
-    putAt(string, y, x);
-    wrefresh(window_);
-    std::this_thread::sleep_for(duration);
-    wmove(window_, y, x);
-    wclrtoeol(window_);
-    wrefresh(window_);
-}
+template<typename Char>
+int Ncurses::Screen::putLines(std::basic_string_view<Char> string, int y, std::optional<int> x, int width) const {
+    const std::vector<typename utils::text::WrapCache<Char>::Line> *lines;
+    if constexpr (std::is_same_v<Char, char>) lines = &layouts_.lines(string, width);
+    else lines = &wideLayouts_.lines(string, width);
 
-void Ncurses::Screen::putFor(const std::wstring &string, int y, int x, std::chrono::seconds duration) const {
-    putAt(string, y, x);
-    wrefresh(window_);
-    std::this_thread::sleep_for(duration);
-    wmove(window_, y, x);
-    wclrtoeol(window_);
-    wrefresh(window_);
-}
-
-static std::vector<std::string> getWrappedLines(const std::string &string, int width) {
-    std::vector<std::string> lines;
-    auto strLen{string.length()};
-
-    for (auto i = 0u; i < strLen;) {
-        auto charWrappedLine = string.substr(i, width);
-        auto lastCharIdx{charWrappedLine.length() - 1};
-
-        // if still other chars in the string and the last char in the substring not '\n' or ' '
-        if (i + width < strLen && charWrappedLine[lastCharIdx] != '\n' && charWrappedLine[lastCharIdx] != ' ') {
-            auto lastSpace{charWrappedLine.find_last_of(' ')};
-            auto wordWrappedLine = charWrappedLine.substr(0, lastSpace);
-            i += static_cast<int>(wordWrappedLine.size());
-            lines.push_back(std::move(wordWrappedLine));
-        } else {
-            i += width;
-            lines.push_back(std::move(charWrappedLine));
-        }
-    }
+    // centered on the cells the line takes, not on its bytes
+    y -= static_cast<int>(lines->size());
+    for (auto line: *lines) draw(line.text, ++y, x ? *x : cols_ / 2 - line.width / 2);
+    return static_cast<int>(lines->size());
+}
 
-    return lines;
+void Ncurses::Screen::reset() {
+    shown_.assign(lines_, {});
+    dirty_ = true;
 }
 
-static std::vector<std::wstring> getWrappedLines(const std::wstring &string, int width) {
-    std::vector<std::wstring> lines;
-    auto strLen{string.length()};
+bool Ncurses::Screen::stage(bool covered) {
+    if (covered) touchwin(window_);
+    if (!dirty_ && !covered) return false;
+    wnoutrefresh(window_);
+    dirty_ = false;
+    return true;
+}
 
-    for (auto i = 0u; i < strLen;) {
-        auto charWrappedLine = string.substr(i, width);
-        auto lastCharIdx{charWrappedLine.length() - 1};
+void Ncurses::Screen::putAt(const std::string &string, int y, int x) const {
+    draw<char>(string, y, x);
+}
 
-        // if still other chars in the string and the last char in the substring not '\n' or ' '
-        if (i + width < strLen && charWrappedLine[lastCharIdx] != '\n' && charWrappedLine[lastCharIdx] != ' ') {
-            auto lastSpace{charWrappedLine.find_last_of(' ')};
-            auto wordWrappedLine = charWrappedLine.substr(0, lastSpace);
-            i += static_cast<int>(wordWrappedLine.size());
-            lines.push_back(std::move(wordWrappedLine));
-        } else {
-            i += width;
-            lines.push_back(std::move(charWrappedLine));
-        }
-    }
 
-    return lines;
+void Ncurses::Screen::putAt(const std::wstring &string, int y, int x) const {
+    draw<wchar_t>(string, y, x);
 }
 
-void Ncurses::Screen::putWrapped(const std::string &string, int y, int x, int width) const {
-    auto lines{getWrappedLines(string, width)};
-    y -= static_cast<int>(lines.size());
+void Ncurses::Screen::putBitmap(std::string_view row, int y, int x) const {
+    if (y < 0 || y >= lines_) return;
 
-    for (auto const &line: lines) {
-        putAt(line, ++y, x);
-    }
+    // solid cells are reversed spaces, which every terminal shows without a block character
+    wmove(window_, y, x);
+    for (auto cell: row) waddch(window_, cell == ' ' ? ' ' : ' ' | A_REVERSE);
+    shown_[y] = {};
+    dirty_ = true;
+}
 
+void Ncurses::Screen::putWrapped(const std::string &string, int y, int x, int width) const {
+    putLines<char>(string, y, x, width);
 }
 
 void Ncurses::Screen::putWrapped(const std::wstring &string, int y, int x, int width) const {
-    auto lines{getWrappedLines(string, width)};
-    y -= static_cast<int>(lines.size());
-
-    for (auto const &line: lines) {
-        putAt(line, ++y, x);
-    }
+    putLines<wchar_t>(string, y, x, width);
 }
 
 void Ncurses::Screen::putCentered(const std::string &string, int y, int width) const {
-    auto lines{getWrappedLines(string, width)};
-    y -= static_cast<int>(lines.size());
-
-    for (auto const &line: lines) {
-        auto x{cols_ / 2 - static_cast<int>(line.size() / 2)};
-        putAt(line, ++y, x);
-    }
+    putLines<char>(string, y, std::nullopt, width);
 }
 
 void Ncurses::Screen::putCentered(const std::wstring &string, int y, int width) const {
-    auto lines{getWrappedLines(string, width)};
-    y -= static_cast<int>(lines.size());
-
-    for (auto const &line: lines) {
-        auto x{cols_ / 2 - static_cast<int>(line.size() / 2)};
-        putAt(line, ++y, x);
-    }
-}
-
-void Ncurses::Screen::putCenteredFor(const std::string &string, int y, int width, std::chrono::seconds duration) const {
-    auto lines{getWrappedLines(string, width)};
-    y -= static_cast<int>(lines.size());
-
-    for (auto const &line: lines) {
-        auto x{cols_ / 2 - static_cast<int>(line.size() / 2)};
-        putAt(line, ++y, x);
-    }
-    std::this_thread::sleep_for(duration);
-    for (auto i{y - static_cast<int>(lines.size()) + 1}; i < y; ++i) {
-        wmove(window_, i, 0);
-        wclrtoeol(window_);
-    }
-    wrefresh(window_);
-}
-
-void
-Ncurses::Screen::putCenteredFor(const std::wstring &string, int y, int width, std::chrono::seconds duration) const {
-    auto lines{getWrappedLines(string, width)};
-    y -= static_cast<int>(lines.size());
-
-    for (auto const &line: lines) {
-        auto x{cols_ / 2 - static_cast<int>(line.size() / 2)};
-        putAt(line, ++y, x);
-    }
-    std::this_thread::sleep_for(duration);
-    for (auto i{y - static_cast<int>(lines.size()) + 1}; i < y; ++i) {
-        wmove(window_, i, 0);
-        wclrtoeol(window_);
-    }
-    wrefresh(window_);
-}
-
-int Ncurses::Screen::ask(const std::wstring &string, const std::wstring &validChars, unsigned int retries) const {
-    int ans;
-    while (retries--) {
-        putAt(string, 0, 0);
-        ans = getCharToLower();
-        if (validChars.find(ans) == std::wstring::npos) {
-            putFor(std::to_wstring(ans) + std::wstring(L" is not a valid answer"), lines_ / 2, cols_ / 2 - 11,
-                   std::chrono::seconds(1));
-            ans = '\0';
-        }
-    }
-    return ans;
+    putLines<wchar_t>(string, y, std::nullopt, width);
 }
 
 void Ncurses::Screen::clear() {
     wclear(window_);
-    wrefresh(window_);
+    reset();
 }
 
 int Ncurses::Screen::getLines() const {
@@ -233,4 +206,7 @@ void Ncurses::Screen::resize(int lines, int cols) {
     cols_ = cols;
     wresize(window_, lines, cols);
     wclear(window_);
+    reset();
+    layouts_.clear();
+    wideLayouts_.clear();
 }
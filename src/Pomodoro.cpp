@@ -0,0 +1,220 @@
+#include <iostream>
+#include <algorithm>
+
+#include "TimewReport.h"
+#include "Pomodoro.h"
+
+Pomodoro::Pomodoro(EventLoop &loop, TerminalView *view, StatusSegment *status, AudioPlayer &audioPlayer,
+                   std::string focusTrack)
+        : loop_(loop), view_(view), status_(status), audioPlayer_(audioPlayer), focusTrack_(std::move(focusTrack)),
+          executor_(loop, [this](const TimewExecutor::Completion &completion) {
+              if (!completion.succeeded) report(completion.error);
+          }) {
+    loop_.watch(timer_.fd(), EPOLLIN, [this](uint32_t) {
+        if (timer_.expired()) tick();
+    });
+
+    // decoded in the background, a session starting right away doesn't wait for them
+    audioPlayer_.load(SoundId::SYNTH_BRASS);
+    audioPlayer_.load(SoundId::RETRO_SYNTH);
+}
+
+Pomodoro::~Pomodoro() {
+    loop_.unwatch(timer_.fd());
+}
+
+void Pomodoro::push(const SessionQueue::Session &task) {
+    if (tasks_.empty()) loop_.post([this] { runTasks(); });
+    tasks_.push(task);
+}
+
+void Pomodoro::pause() {
+    push({{}, {}, TimewCommand::STOP});
+}
+
+CoalesceStats Pomodoro::coalesced() const {
+    return {tasks_.stats().merged + executor_.stats().merged, tasks_.stats().dropped + executor_.stats().dropped};
+}
+
+void Pomodoro::trackingChanged(bool isTracking) {
+    if (isTracking) {
+        // tracking started during a focus session is the session resuming itself
+        if (!isFocus_) push({std::chrono::minutes(25), std::chrono::minutes(5), TimewCommand::QUERY});
+    } else if (isFocus_) {
+        interrupt();
+    }
+}
+
+bool Pomodoro::isPaused() const {
+    return isPause_;
+}
+
+const StatusSegment::Status &Pomodoro::status() const {
+    return current_;
+}
+
+void Pomodoro::report(const std::string &message) {
+    if (view_) view_->toast(message, std::chrono::seconds(2));
+    else std::cerr << message << '\n';
+}
+
+void Pomodoro::runTasks() {
+    while (auto task{tasks_.pop()}) {
+        if (task->timewCommand == TimewCommand::STOP) {
+            interrupt();
+            executor_.submit(TimewCommand::STOP);
+        } else {
+            start(*task);
+        }
+    }
+}
+
+void Pomodoro::start(const SessionQueue::Session &task) {
+    stopCountDown();
+    auto session{++session_};
+    isPause_ = false;
+    isFocus_ = true;
+    if (view_) view_->clear();
+
+    auto query = [this, session, task] {
+        executor_.submit(TimewCommand::QUERY, [this, session, task](const TimewExecutor::Completion &completion) {
+            if (session != session_) return;   // replaced or paused meanwhile
+            if (!completion.succeeded) return stopSession();
+            startFocus(task, completion.query);
+        });
+    };
+
+    // continuing goes through the executor so that it is ordered after, or cancels, a pending stop
+    if (task.timewCommand == TimewCommand::RESUME) {
+        auto resumed = [this, session, task, query](const TimewExecutor::Completion &completion) {
+            if (session != session_) return;
+            if (!completion.succeeded) return stopSession();
+
+            // `timew continue` reports the resumed interval, a continue that cancelled a stop has no output
+            auto &output{completion.process.output};
+            if (auto report{TimewReport::parse(output)}; report && report->isTracking)
+                return startFocus(task, {report->total, report->description(), true});
+            query();
+        };
+        executor_.submit(TimewCommand::RESUME, resumed);
+    } else {
+        query();
+    }
+}
+
+void Pomodoro::startFocus(const SessionQueue::Session &task, const TimewQueryResult &tracking) {
+    std::chrono::duration<int64_t, std::nano> focusDuration{task.focusDuration};
+    if (task.timewCommand == TimewCommand::RESUME && tracking.isTracking) {
+        if (tracking.trackedTime > task.focusDuration)
+            focusDuration = std::chrono::duration<long, std::nano>(0);
+        else
+            focusDuration = task.focusDuration - tracking.trackedTime;
+    }
+
+    auto pomodoroDuration{std::chrono::duration_cast<std::chrono::seconds>(task.focusDuration)};
+    if (view_) view_->showStats(pomodoroDuration);
+
+    auto taskDescription{tracking.taskDescription};
+    startCountDown(StatusSegment::Phase::FOCUS, "Focus!", taskDescription, focusDuration,
+                   [this, task, pomodoroDuration, taskDescription] {
+        isFocus_ = false;
+        audioPlayer_.play(SoundId::RETRO_SYNTH);
+        executor_.submit(TimewCommand::STOP);
+
+        startCountDown(StatusSegment::Phase::BREAK, "Break", taskDescription, task.breakDuration,
+                       [this, pomodoroDuration] {
+            isPause_ = true;
+            audioPlayer_.play(SoundId::SYNTH_BRASS);
+            publish({});
+            if (view_) view_->showStats(pomodoroDuration);
+        });
+    });
+}
+
+void Pomodoro::interrupt() {
+    if (countDown_) {
+        StatusSegment::Status status{0, (countDown_->end - timer_.now()).count(), countDown_->phase, true};
+        status.setTask(countDown_->taskDescription);
+        publish(status);
+    } else {
+        publish({});
+    }
+    stopCountDown();
+    ++session_;
+    isPause_ = true;
+    isFocus_ = false;
+}
+
+void Pomodoro::stopSession() {
+    ++session_;
+    isPause_ = true;
+    isFocus_ = false;
+    publish({});
+}
+
+void Pomodoro::startCountDown(StatusSegment::Phase phase, const std::string &title,
+                              const std::string &taskDescription, std::chrono::nanoseconds duration,
+                              std::function<void()> finished) {
+    auto now{timer_.now()};
+    countDown_ = {phase, title, taskDescription, now, now + duration, std::move(finished)};
+
+    StatusSegment::Status status{countDown_->end.count(), duration.count(), phase, false};
+    status.setTask(taskDescription);
+    publish(status);
+
+    if (duration.count() <= 0) return tick();
+    if (phase == StatusSegment::Phase::FOCUS) playFocusTrack();
+    draw();
+    timer_.arm(std::min(now + std::chrono::seconds(1), countDown_->end));
+}
+
+void Pomodoro::stopCountDown() {
+    timer_.disarm();
+    countDown_.reset();
+    stopFocusTrack();
+}
+
+void Pomodoro::playFocusTrack() {
+    if (focusTrack_.empty()) return;
+    try {
+        audioPlayer_.stream(focusTrack_, true);
+    } catch (const std::runtime_error &error) {
+        report(error.what());
+    }
+}
+
+void Pomodoro::stopFocusTrack() {
+    if (!focusTrack_.empty()) audioPlayer_.stop(focusTrack_);
+}
+
+void Pomodoro::tick() {
+    if (!countDown_) return;
+
+    // every tick is a fixed offset from the start, a late wakeup doesn't delay the ones after it, and the ticks
+    // missed while the system was suspended are skipped
+    auto next{std::min(countDown_->deadline + std::chrono::seconds(1), countDown_->end)};
+    auto missed{std::max((timer_.now() - next) / std::chrono::seconds(1), int64_t{0})};
+    countDown_->deadline = std::min(next + std::chrono::seconds(missed), countDown_->end);
+
+    if (countDown_->deadline >= countDown_->end) {
+        auto finished{std::move(countDown_->finished)};
+        countDown_.reset();
+        stopFocusTrack();
+        finished();
+        return;
+    }
+
+    draw();
+    timer_.arm(std::min(countDown_->deadline + std::chrono::seconds(1), countDown_->end));
+}
+
+void Pomodoro::draw() {
+    if (view_)
+        view_->showCountDown(countDown_->title, countDown_->taskDescription,
+                             countDown_->end - countDown_->deadline);
+}
+
+void Pomodoro::publish(const StatusSegment::Status &status) {
+    current_ = status;
+    if (status_) status_->publish(status);
+}
@@ -0,0 +1,49 @@
+#include <algorithm>
+
+#include "Renderer.h"
+
+Renderer::Renderer(EventLoop &loop, const Ncurses::Screen &toastScreen) : loop_(loop), toastScreen_(toastScreen) {
+    loop_.watch(timer_.fd(), EPOLLIN, [this](uint32_t) {
+        if (timer_.expired()) expire();
+    });
+
+    // whatever the handlers of an iteration drew reaches the terminal as one frame
+    loop_.beforeWait([] { Ncurses::render(); });
+}
+
+Renderer::~Renderer() {
+    loop_.beforeWait({});
+    loop_.unwatch(timer_.fd());
+}
+
+void Renderer::draw(std::function<void()> command) {
+    if (std::this_thread::get_id() == thread_) command();
+    else loop_.post(std::move(command));
+}
+
+void Renderer::toast(std::string message, std::chrono::milliseconds duration) {
+    draw([this, message = std::move(message), duration]() mutable {
+        toasts_.push_back({std::move(message), timer_.now() + duration});
+        expire();
+    });
+}
+
+void Renderer::redraw() {
+    auto line{toastScreen_.getLines() - 1};
+    toastScreen_.putAt(toasts_.empty() ? std::string() : toasts_.back().message, line, 0);
+}
+
+void Renderer::expire() {
+    auto now{timer_.now()};
+    std::erase_if(toasts_, [now](const Toast &toast) { return toast.deadline <= now; });
+    redraw();
+
+    if (toasts_.empty()) {
+        timer_.disarm();
+        return;
+    }
+    auto next{std::min_element(toasts_.begin(), toasts_.end(), [](const Toast &a, const Toast &b) {
+        return a.deadline < b.deadline;
+    })};
+    timer_.arm(next->deadline);
+}
@@ -0,0 +1,179 @@
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#endif
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "SampleFormat.h"
+
+using utils::pcm::Encoding;
+
+static int16_t fromUnsigned8(const char *sample) {
+    return static_cast<int16_t>((static_cast<unsigned char>(*sample) - 128) * 256);
+}
+
+static int16_t fromSigned16(const char *sample) {
+    int16_t value;
+    std::memcpy(&value, sample, sizeof(value));
+    return value;
+}
+
+static int16_t fromSigned24(const char *sample) {
+    // the two high bytes
+    return fromSigned16(sample + 1);
+}
+
+static int16_t fromSigned32(const char *sample) {
+    int32_t value;
+    std::memcpy(&value, sample, sizeof(value));
+    return static_cast<int16_t>(value >> 16);
+}
+
+static int16_t fromFloat32(const char *sample) {
+    float value;
+    std::memcpy(&value, sample, sizeof(value));
+    // compared like the vector min and max, a NaN clips to the top
+    value *= 32768.0f;
+    value = value < 32767.0f ? value : 32767.0f;
+    value = value > -32768.0f ? value : -32768.0f;
+    return static_cast<int16_t>(std::lrintf(value));
+}
+
+template<int16_t (*Sample)(const char *), std::size_t Bytes>
+static void convert(const char *in, int16_t *out, std::size_t from, std::size_t count) {
+    for (auto i{from}; i < count; ++i) out[i] = Sample(in + i * Bytes);
+}
+
+/**
+ * Converts the samples a vector at a time
+ * @return the number of samples converted, the rest is left to the scalar loop
+ */
+static std::size_t toSigned16Vector(Encoding encoding, const char *in, int16_t *out, std::size_t count) {
+    std::size_t i{0};
+#if defined(__SSE2__)
+    switch (encoding) {
+        case Encoding::UNSIGNED_8: {
+            // flipping the sign bit makes the samples signed, then they become the high byte
+            auto sign{_mm_set1_epi8(static_cast<char>(0x80))}, zero{_mm_setzero_si128()};
+            for (; i + 16 <= count; i += 16) {
+                auto x{_mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i)), sign)};
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_unpacklo_epi8(zero, x));
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i + 8), _mm_unpackhi_epi8(zero, x));
+            }
+            break;
+        }
+        case Encoding::SIGNED_24: {
+#if defined(__SSSE3__)
+            // 4 samples of 12 bytes out of each load, the loads read 4 bytes past them
+            auto high{_mm_setr_epi8(1, 2, 4, 5, 7, 8, 10, 11, -1, -1, -1, -1, -1, -1, -1, -1)};
+            for (; (i + 8) * 3 + 4 <= count * 3; i += 8) {
+                auto low{_mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i * 3)), high)};
+                auto next{_mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i * 3 + 12)), high)};
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_unpacklo_epi64(low, next));
+            }
+#endif
+            break;
+        }
+        case Encoding::SIGNED_32:
+            for (; i + 8 <= count; i += 8) {
+                auto low{_mm_srai_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i * 4)), 16)};
+                auto next{_mm_srai_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i * 4 + 16)), 16)};
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_packs_epi32(low, next));
+            }
+            break;
+        case Encoding::FLOAT_32: {
+            auto scale{_mm_set1_ps(32768.0f)}, top{_mm_set1_ps(32767.0f)}, bottom{_mm_set1_ps(-32768.0f)};
+            auto clip = [&](__m128 x) {
+                return _mm_cvtps_epi32(_mm_max_ps(_mm_min_ps(_mm_mul_ps(x, scale), top), bottom));
+            };
+            for (; i + 8 <= count; i += 8) {
+                auto low{clip(_mm_loadu_ps(reinterpret_cast<const float *>(in + i * 4)))};
+                auto next{clip(_mm_loadu_ps(reinterpret_cast<const float *>(in + i * 4 + 16)))};
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_packs_epi32(low, next));
+            }
+            break;
+        }
+        default:
+            break;
+    }
+#elif defined(__aarch64__)
+    auto bytes{reinterpret_cast<const uint8_t *>(in)};
+    switch (encoding) {
+        case Encoding::UNSIGNED_8:
+            for (; i + 16 <= count; i += 16) {
+                auto x{veorq_u8(vld1q_u8(bytes + i), vdupq_n_u8(0x80))};
+                vst1q_s16(out + i, vreinterpretq_s16_u16(vshll_n_u8(vget_low_u8(x), 8)));
+                vst1q_s16(out + i + 8, vreinterpretq_s16_u16(vshll_high_n_u8(x, 8)));
+            }
+            break;
+        case Encoding::SIGNED_24:
+            // the bytes are split by their place in the samples, the two high ones are interleaved back
+            for (; i + 16 <= count; i += 16) {
+                auto x{vld3q_u8(bytes + i * 3)};
+                vst1q_s16(out + i, vreinterpretq_s16_u8(vzip1q_u8(x.val[1], x.val[2])));
+                vst1q_s16(out + i + 8, vreinterpretq_s16_u8(vzip2q_u8(x.val[1], x.val[2])));
+            }
+            break;
+        case Encoding::SIGNED_32:
+            for (; i + 8 <= count; i += 8) {
+                auto low{vshrn_n_s32(vld1q_s32(reinterpret_cast<const int32_t *>(bytes + i * 4)), 16)};
+                auto next{vshrn_n_s32(vld1q_s32(reinterpret_cast<const int32_t *>(bytes + i * 4 + 16)), 16)};
+                vst1q_s16(out + i, vcombine_s16(low, next));
+            }
+            break;
+        case Encoding::FLOAT_32: {
+            auto scale{vdupq_n_f32(32768.0f)}, top{vdupq_n_f32(32767.0f)}, bottom{vdupq_n_f32(-32768.0f)};
+            auto clip = [&](float32x4_t x) {
+                return vqmovn_s32(vcvtnq_s32_f32(vmaxnmq_f32(vminnmq_f32(vmulq_f32(x, scale), top), bottom)));
+            };
+            for (; i + 8 <= count; i += 8) {
+                auto low{clip(vld1q_f32(reinterpret_cast<const float *>(bytes + i * 4)))};
+                auto next{clip(vld1q_f32(reinterpret_cast<const float *>(bytes + i * 4 + 16)))};
+                vst1q_s16(out + i, vcombine_s16(low, next));
+            }
+            break;
+        }
+        default:
+            break;
+    }
+#else
+    (void) encoding, (void) in, (void) out, (void) count;
+#endif
+    return i;
+}
+
+static void convertFrom(Encoding encoding, const char *in, int16_t *out, std::size_t from, std::size_t count) {
+    switch (encoding) {
+        case Encoding::UNSIGNED_8:
+            return convert<fromUnsigned8, 1>(in, out, from, count);
+        case Encoding::SIGNED_16:
+            return convert<fromSigned16, 2>(in, out, from, count);
+        case Encoding::SIGNED_24:
+            return convert<fromSigned24, 3>(in, out, from, count);
+        case Encoding::SIGNED_32:
+            return convert<fromSigned32, 4>(in, out, from, count);
+        case Encoding::FLOAT_32:
+            return convert<fromFloat32, 4>(in, out, from, count);
+    }
+}
+
+void utils::pcm::toSigned16(Encoding encoding, std::string_view samples, int16_t *out) {
+    auto count{samples.size() / sampleBytes(encoding)};
+    if (count == 0) return;
+    if (encoding == Encoding::SIGNED_16) {
+        std::memcpy(out, samples.data(), count * sizeof(int16_t));
+        return;
+    }
+    auto converted{toSigned16Vector(encoding, samples.data(), out, count)};
+    convertFrom(encoding, samples.data(), out, converted, count);
+}
+
+void utils::pcm::toSigned16Scalar(Encoding encoding, std::string_view samples, int16_t *out) {
+    convertFrom(encoding, samples.data(), out, 0, samples.size() / sampleBytes(encoding));
+}
@@ -0,0 +1,70 @@
+#include <algorithm>
+
+#include "SessionQueue.h"
+
+static bool isControl(const SessionQueue::Session &session) {
+    return session.timewCommand == TimewCommand::STOP || session.timewCommand == TimewCommand::RESUME;
+}
+
+static bool isCommand(const SessionQueue::Session &session, TimewCommand command) {
+    return session.timewCommand == command;
+}
+
+void SessionQueue::push(const Session &session) {
+    auto queued = [this](TimewCommand command) {
+        return std::any_of(sessions_.begin(), sessions_.end(), [command](const Session &s) {
+            return isCommand(s, command);
+        });
+    };
+    auto erase = [this](TimewCommand command) {
+        auto count{std::erase_if(sessions_, [command](const Session &s) { return isCommand(s, command); })};
+        return static_cast<unsigned int>(count);
+    };
+
+    switch (session.timewCommand) {
+        case TimewCommand::QUERY:
+            // every query restarts the session, only the latest one matters
+            stats_.merged += erase(TimewCommand::QUERY);
+            sessions_.push_back(session);
+            return;
+        case TimewCommand::STOP:
+            // the sessions queued before a stop would be paused right after they started
+            stats_.dropped += erase(TimewCommand::RESUME) + erase(TimewCommand::QUERY);
+            if (queued(TimewCommand::STOP)) {
+                ++stats_.merged;
+                return;
+            }
+            break;
+        case TimewCommand::RESUME:
+            if (queued(TimewCommand::STOP)) {
+                ++stats_.dropped;
+                return;
+            }
+            if (queued(TimewCommand::RESUME)) {
+                ++stats_.merged;
+                return;
+            }
+            break;
+        default:
+            sessions_.push_back(session);
+            return;
+    }
+
+    // control commands keep their order among themselves, ahead of the queued work
+    sessions_.insert(std::find_if_not(sessions_.begin(), sessions_.end(), isControl), session);
+}
+
+std::optional<SessionQueue::Session> SessionQueue::pop() {
+    if (sessions_.empty()) return std::nullopt;
+    auto session{sessions_.front()};
+    sessions_.pop_front();
+    return session;
+}
+
+bool SessionQueue::empty() const {
+    return sessions_.empty();
+}
+
+const CoalesceStats &SessionQueue::stats() const {
+    return stats_;
+}
@@ -0,0 +1,214 @@
+#include <ctime>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "config.h"
+#include "StatusSegment.h"
+
+static constexpr uint32_t layoutMagic{0x504F4D31};    // "POM1", bumped when the layout changes
+static constexpr std::size_t statusWords{sizeof(StatusSegment::Status) / sizeof(uint64_t)};
+static constexpr int readRetries{1000};
+
+/**
+ * The segment, the status is kept in atomic words so that a reader racing with the writer copies torn words instead
+ * of racing on plain memory, and discards them when the sequence changed
+ */
+struct StatusSegment::Layout {
+    std::atomic<uint32_t> magic;
+    std::atomic<uint32_t> sequence;     // odd while the status is written
+    std::atomic<uint64_t> words[statusWords];
+};
+
+static_assert(std::atomic<uint32_t>::is_always_lock_free && std::atomic<uint64_t>::is_always_lock_free,
+              "the atomics of the segment are shared between processes");
+
+/**
+ * Opens a segment, bionic has no shm_open so on Android the segment is a file in the temporary directory
+ */
+static int openSegment(const std::string &name, int flags, mode_t mode) {
+#ifdef __ANDROID__
+    auto directory{std::getenv("TMPDIR")};
+    return open((std::string(directory ? directory : "/data/local/tmp") + name).c_str(), flags, mode);
+#else
+    return shm_open(name.c_str(), flags, mode);
+#endif
+}
+
+static void unlinkSegment(const std::string &name) {
+#ifdef __ANDROID__
+    auto directory{std::getenv("TMPDIR")};
+    unlink((std::string(directory ? directory : "/data/local/tmp") + name).c_str());
+#else
+    shm_unlink(name.c_str());
+#endif
+}
+
+/**
+ * Checks whether a process holds the write lock on the segment without taking any lock
+ */
+static bool isPublished(int fd) {
+    struct flock lock{};
+    lock.l_type = F_WRLCK;
+    lock.l_whence = SEEK_SET;
+    return fcntl(fd, F_OFD_GETLK, &lock) == 0 && lock.l_type != F_UNLCK;
+}
+
+void StatusSegment::Status::setTask(std::string_view description) {
+    auto length{std::min(description.size(), sizeof(task) - 1)};
+    // a UTF-8 continuation byte after the cut means a character is split
+    while (length > 0 && length < description.size() &&
+           (static_cast<unsigned char>(description[length]) & 0xC0) == 0x80)
+        --length;
+    std::memcpy(task, description.data(), length);
+    task[length] = '\0';
+}
+
+std::string StatusSegment::defaultName() {
+    return "/" PROJECT_NAME "-" + std::to_string(getuid());
+}
+
+StatusSegment::StatusSegment(std::string name) : name_(std::move(name)) {
+    fd_ = openSegment(name_, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+    if (fd_ == -1) throw std::runtime_error("Failed to open the status segment " + name_);
+
+    // the lock belongs to the open file and goes away with the process, so a segment left by a crash is taken over
+    struct flock lock{};
+    lock.l_type = F_WRLCK;
+    lock.l_whence = SEEK_SET;
+    if (fcntl(fd_, F_OFD_SETLK, &lock) == -1) {
+        close(fd_);
+        throw std::runtime_error("Another process publishes its status to " + name_);
+    }
+
+    void *memory;
+    if (ftruncate(fd_, sizeof(Layout)) == -1 ||
+        (memory = mmap(nullptr, sizeof(Layout), PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0)) == MAP_FAILED) {
+        close(fd_);
+        throw std::runtime_error("Failed to map the status segment " + name_);
+    }
+    layout_ = static_cast<Layout *>(memory);
+    publish({});
+    layout_->magic.store(layoutMagic, std::memory_order_release);
+}
+
+StatusSegment::~StatusSegment() {
+    unlinkSegment(name_);
+    munmap(layout_, sizeof(Layout));
+    close(fd_);
+}
+
+void StatusSegment::publish(const Status &status) {
+    uint64_t words[statusWords];
+    std::memcpy(words, &status, sizeof(words));
+
+    // odd while writing, a sequence left odd by a writer that died mid-write stays odd until the copy is complete
+    auto sequence{layout_->sequence.load(std::memory_order_relaxed) | 1u};
+    layout_->sequence.store(sequence, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    for (std::size_t i{0}; i < statusWords; ++i) layout_->words[i].store(words[i], std::memory_order_relaxed);
+    layout_->sequence.store(sequence + 1, std::memory_order_release);
+}
+
+std::optional<StatusSegment::Status> StatusSegment::read(const std::string &name) {
+    auto fd{openSegment(name, O_RDONLY | O_CLOEXEC, 0)};
+    if (fd == -1) return std::nullopt;
+
+    struct stat info{};
+    if (!isPublished(fd) || fstat(fd, &info) == -1 || info.st_size < static_cast<off_t>(sizeof(Layout))) {
+        close(fd);
+        return std::nullopt;
+    }
+    auto memory{mmap(nullptr, sizeof(Layout), PROT_READ, MAP_SHARED, fd, 0)};
+    close(fd);
+    if (memory == MAP_FAILED) return std::nullopt;
+
+    auto layout{static_cast<const Layout *>(memory)};
+    std::optional<Status> status;
+    if (layout->magic.load(std::memory_order_acquire) == layoutMagic) {
+        for (auto i{0}; i < readRetries && !status; ++i) {
+            auto before{layout->sequence.load(std::memory_order_acquire)};
+            if (before & 1u) continue;
+
+            uint64_t words[statusWords];
+            for (std::size_t w{0}; w < statusWords; ++w) words[w] = layout->words[w].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (layout->sequence.load(std::memory_order_relaxed) != before) continue;
+
+            status.emplace();
+            std::memcpy(&*status, words, sizeof(words));
+            status->task[sizeof(status->task) - 1] = '\0';
+        }
+    }
+    munmap(memory, sizeof(Layout));
+    return status;
+}
+
+static std::string_view state(const StatusSegment::Status &status) {
+    if (status.paused) return "paused";
+    switch (status.phase) {
+        case StatusSegment::Phase::FOCUS:
+            return "focus";
+        case StatusSegment::Phase::BREAK:
+            return "break";
+        default:
+            return "idle";
+    }
+}
+
+/**
+ * Get the whole seconds left, counted from the end on the clock of the timer so that a status bar polling between
+ * two ticks still shows the right second
+ */
+static long long remainingSeconds(const StatusSegment::Status &status) {
+    auto remaining{status.remaining};
+    if (status.end != 0) {
+        timespec now{};
+        clock_gettime(CLOCK_BOOTTIME, &now);
+        remaining = status.end - (now.tv_sec * 1'000'000'000LL + now.tv_nsec);
+    }
+    return remaining > 0 ? (remaining + 999'999'999) / 1'000'000'000 : 0;
+}
+
+std::string StatusSegment::format(const Status &status, std::string_view format) {
+    // without a format an idle timer is a single word instead of a zero count down
+    if (format.empty()) format = status.phase == Phase::IDLE ? "%s" : "%s %r %t";
+
+    std::string line;
+    for (std::size_t i{0}; i < format.size(); ++i) {
+        if (format[i] != '%' || i + 1 == format.size()) {
+            line += format[i];
+            continue;
+        }
+        switch (format[++i]) {
+            case 's':
+                line += state(status);
+                break;
+            case 'r': {
+                auto seconds{remainingSeconds(status)};
+                char time[32];
+                if (seconds >= 3600)
+                    std::snprintf(time, sizeof(time), "%lld:%02lld:%02lld", seconds / 3600, seconds / 60 % 60,
+                                  seconds % 60);
+                else
+                    std::snprintf(time, sizeof(time), "%02lld:%02lld", seconds / 60, seconds % 60);
+                line += time;
+                break;
+            }
+            case 't':
+                line += status.task;
+                break;
+            default:
+                line += format[i];
+                break;
+        }
+    }
+    return line;
+}
@@ -0,0 +1,102 @@
+#include <utility>
+#include <algorithm>
+
+#include "utils.h"
+#include "Timew.h"
+#include "TextWidth.h"
+#include "TimewData.h"
+#include "TimewHistory.h"
+#include "TerminalView.h"
+
+static constexpr int tmrScreenLines = 2;
+static constexpr int tmrScreenY = 2;        // under the commands and the stats
+static constexpr int cmdBottomLines = 3;    // the description and the message under the timer
+static constexpr std::size_t statsTags = 2; // the most tracked tags of the week shown with the stats
+
+// the export is killed past it, exiting waits for the stats being read
+static constexpr std::chrono::seconds statsTimeout{2};
+
+TerminalView::TerminalView(EventLoop &loop)
+        : tmrScreen_(tmrScreenLines, COLS, tmrScreenY, 0), renderer_(loop, cmdScreen_) {
+    resize();   // the clock is sized for the terminal before the first frame
+}
+
+const Ncurses::Screen &TerminalView::input() const {
+    return cmdScreen_;
+}
+
+void TerminalView::clear() {
+    countDown_.reset();
+    cmdScreen_.clear();
+    PUT_CENTERED(cmdScreen_, "commands: (c)ontinue, (p)ause, (e)xit", 0);
+    renderer_.redraw();
+}
+
+void TerminalView::showStats(std::chrono::seconds focusDuration) {
+    if (statsRunning_) {
+        statsPending_ = focusDuration;  // read again once the running stats are drawn
+        return;
+    }
+    statsRunning_ = true;
+    statsThread_ = std::jthread([this, focusDuration, width = cmdScreen_.getCols()] {
+        renderer_.draw([this, line = statsLine(focusDuration, width)] {
+            if (!line.empty()) cmdScreen_.putCentered(line, 1, cmdScreen_.getCols());
+            statsRunning_ = false;
+            if (auto pending{std::exchange(statsPending_, std::nullopt)}) showStats(*pending);
+        });
+    });
+}
+
+void TerminalView::showCountDown(const std::string &title, const std::string &taskDescription,
+                                 std::chrono::nanoseconds remaining) {
+    countDown_ = {title, taskDescription, utils::formatSeconds(remaining)};
+    drawCountDown();
+}
+
+void TerminalView::toast(std::string message, std::chrono::milliseconds duration) {
+    renderer_.toast(std::move(message), duration);
+}
+
+void TerminalView::resize() {
+    int lines, cols;
+    getmaxyx(stdscr, lines, cols);
+    cmdScreen_.resize(lines, cols);
+    tmrScreen_.resize(1 + clock_.fit(lines - tmrScreenY - cmdBottomLines - 1, cols), cols);
+    PUT_CENTERED(cmdScreen_, "commands: (c)ontinue, (p)ause, (e)xit", 0);
+    if (countDown_) drawCountDown();
+    renderer_.redraw();
+}
+
+std::string TerminalView::statsLine(std::chrono::seconds focusDuration, int width) {
+    try {
+        auto stats{Timew::stats(focusDuration, statsTimeout)};
+        auto line{"today " + utils::formatSeconds(stats.todayFocus) + " (" +
+                  std::to_string(stats.todayPomodoros) + " pomodoros), this week " +
+                  utils::formatSeconds(stats.weekFocus) + " (" + std::to_string(stats.weekPomodoros) +
+                  " pomodoros)"};
+        if (auto dataDirectory{TimewData::dataDirectory()}; !dataDirectory.empty()) {
+            auto cacheDirectory{utils::cacheDirectory()};
+            auto history{TimewHistory::load(dataDirectory, cacheDirectory.empty() ? cacheDirectory :
+                                                           cacheDirectory / "index")};
+            if (auto streak{history.streak(stats.now)}; streak > 1)
+                line.append(", " + std::to_string(streak) + " day streak");
+
+            // only the tags that fit, a wrapped line would cover the commands
+            auto byTag{history.focusByTag(stats.startOfWeek, stats.now)};
+            for (auto i{0u}; i < std::min<std::size_t>(byTag.size(), statsTags); ++i) {
+                auto tag{(i == 0 ? ", +" : " +") + byTag[i].first + " " + utils::formatSeconds(byTag[i].second)};
+                if (utils::text::displayWidth(line) + utils::text::displayWidth(tag) > width) break;
+                line.append(tag);
+            }
+        }
+        return line;
+    } catch (const std::runtime_error &) {    // the stats are only informative
+        return {};
+    }
+}
+
+void TerminalView::drawCountDown() {
+    tmrScreen_.putCentered(countDown_->title, 0, static_cast<int>(countDown_->title.size()));
+    clock_.draw(countDown_->time, 1);
+    cmdScreen_.putCentered(countDown_->taskDescription, cmdScreen_.getLines() - 2, cmdScreen_.getCols() - 11);
+}
@@ -0,0 +1,61 @@
+#include <cstdint>
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#include <arm_neon.h>
+#endif
+
+#include "TextWidth.h"
+
+std::size_t utils::text::asciiPrefix(std::string_view text) {
+    auto data{text.data()};
+    std::size_t i{0};
+
+#if defined(__SSE2__)
+    for (; i + 16 <= text.size(); i += 16) {
+        auto mask{_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)))};
+        if (mask != 0) return i + __builtin_ctz(static_cast<unsigned int>(mask));
+    }
+#elif defined(__aarch64__)
+    for (; i + 16 <= text.size(); i += 16) {
+        if (vmaxvq_u8(vld1q_u8(reinterpret_cast<const uint8_t *>(data + i))) >= 0x80) break;
+    }
+#endif
+
+    // eight bytes at a time, then the tail
+    for (; i + 8 <= text.size(); i += 8) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        if ((word & 0x8080808080808080ull) != 0) break;
+    }
+    while (i < text.size() && static_cast<unsigned char>(data[i]) < 0x80) ++i;
+    return i;
+}
+
+std::size_t utils::text::asciiPrefix(std::wstring_view text) {
+    std::size_t i{0};
+    while (i < text.size() && static_cast<uint32_t>(text[i]) < 0x80) ++i;
+    return i;
+}
+
+template<typename Char>
+static int width(std::basic_string_view<Char> text) {
+    int cells{0};
+    for (std::size_t pos{0}; pos < text.size();) {
+        auto run{utils::text::asciiPrefix(text.substr(pos))};
+        cells += static_cast<int>(run);
+        pos += run;
+        if (pos < text.size()) cells += utils::text::cellWidth(utils::text::decode(text, pos));
+    }
+    return cells;
+}
+
+int utils::text::displayWidth(std::string_view text) {
+    return width(text);
+}
+
+int utils::text::displayWidth(std::wstring_view text) {
+    return width(text);
+}
@@ -0,0 +1,156 @@
+#include <ctime>
+#include <algorithm>
+
+#include "Timew.h"
+#include "JsonStreamParser.h"
+
+static std::chrono::seconds trackedSince(std::chrono::system_clock::time_point start) {
+    auto trackedTime{std::chrono::system_clock::now() - start};
+    return std::max(std::chrono::duration_cast<std::chrono::seconds>(trackedTime), std::chrono::seconds(0));
+}
+
+/**
+ * Joins tags the way timew shows them, quoting the ones containing spaces
+ */
+static std::string joinTags(const std::vector<std::string> &tags) {
+    std::string joined;
+    for (const auto &tag: tags) {
+        if (!joined.empty()) joined.append(1, ' ');
+        if (tag.find(' ') != std::string::npos)
+            joined.append(1, '"').append(tag).append(1, '"');
+        else
+            joined.append(tag);
+    }
+    return joined;
+}
+
+/**
+ * Reads the start and the tags of the interval object of `timew get dom.tracked.1.json`
+ */
+class DomInterval {
+public:
+    std::string start;
+    std::vector<std::string> tags;
+
+    /* events of utils::json::StreamParser */
+    void startObject() {
+        ++depth_;
+    }
+
+    void endObject() {
+        --depth_;
+    }
+
+    void startArray() {
+        ++depth_;
+    }
+
+    void endArray() {
+        --depth_;
+        field_ = Field::NONE;
+    }
+
+    void key(std::string_view key) {
+        // { "id": 1, "start": ..., "tags": [ ... ] }
+        if (depth_ == 1) field_ = key == "start" ? Field::START : key == "tags" ? Field::TAGS : Field::NONE;
+    }
+
+    void string(std::string_view value) {
+        if (field_ == Field::START && depth_ == 1) {
+            start = value;
+            field_ = Field::NONE;
+        } else if (field_ == Field::TAGS && depth_ == 2) {
+            tags.emplace_back(value);
+        }
+    }
+
+    void number(std::string_view) {
+        if (depth_ == 1) field_ = Field::NONE;
+    }
+
+    void literal(std::string_view) {
+        if (depth_ == 1) field_ = Field::NONE;
+    }
+
+private:
+    enum class Field {
+        NONE, START, TAGS
+    };
+
+    unsigned int depth_ = 0;
+    Field field_ = Field::NONE;
+};
+
+std::vector<const char *> Timew::arguments(TimewCommand command) {
+    switch (command) {
+        case TimewCommand::STOP:
+            return {"stop", ":adjust", nullptr};
+        case TimewCommand::RESUME:
+            return {"continue", nullptr};
+        case TimewCommand::QUERY:
+            // dom.tracked.1 is the latest interval, which is the active one while tracking, asking for
+            // dom.active.* instead would fail the whole command whenever nothing is tracked
+            return {"get", "dom.active", "dom.tracked.1.json", nullptr};
+        default:
+            throw std::logic_error("Unsupported timew command");
+    }
+}
+
+TimewQueryResult Timew::query() {
+    if (auto dataFile{TimewData::latestFile()}; !dataFile.empty()) return queryData(dataFile);
+    return parseDom(utils::executeProcess(executable, arguments(TimewCommand::QUERY)));
+}
+
+TimewQueryResult Timew::queryData(const std::filesystem::path &dataFile) {
+    TimewData data(dataFile);
+    auto now{std::chrono::system_clock::now()};
+    auto todayTotal{data.trackedSince(FocusStats(now, std::chrono::seconds(0)).startOfToday, now)};
+
+    auto interval{data.lastInterval()};
+    if (!interval || !interval->isOpen()) return {std::chrono::seconds(0), "", false, {}, {}, todayTotal};
+
+    return {trackedSince(interval->start), TimewData::formatTags(interval->tags), true, interval->start,
+            TimewData::splitTags(interval->tags), todayTotal};
+}
+
+TimewQueryResult Timew::parseDom(const utils::ProcessResult &result) {
+    if (result.exitCode != 0) return {std::chrono::seconds(0), "", false};    // nothing was ever tracked
+
+    std::string_view output{result.output};
+    auto valueStart{output.find_first_not_of(" \n")};
+    if (valueStart == std::string_view::npos || output[valueStart] != '1')
+        return {std::chrono::seconds(0), "", false};
+
+    auto jsonStart{output.find('{')};
+    if (jsonStart == std::string_view::npos) throw std::runtime_error("Failed to parse timew command output");
+    DomInterval interval;
+    utils::json::StreamParser<DomInterval> parser(interval);
+    parser.feed(output.substr(jsonStart));
+    parser.finish();
+
+    auto start{TimewData::parseTimestamp(interval.start)};
+    if (!start) throw std::runtime_error("Failed to parse timew command output");
+    auto tags{std::move(interval.tags)};
+
+    auto description{joinTags(tags)};
+    return {trackedSince(*start), std::move(description), true, *start, std::move(tags)};
+}
+
+FocusStats Timew::stats(std::chrono::seconds focusDuration, std::chrono::milliseconds timeout) {
+    FocusStats stats(std::chrono::system_clock::now(), focusDuration);
+    TimewExport timewExport([&](const TimewExportInterval &interval) { stats.add(interval); });
+
+    // "from" takes a local date, only the intervals overlapping this week are exported
+    auto weekStart{std::chrono::system_clock::to_time_t(stats.startOfWeek)};
+    std::tm local{};
+    localtime_r(&weekStart, &local);
+    char from[32];
+    std::strftime(from, sizeof(from), "%Y-%m-%dT%H:%M:%S", &local);
+
+    auto result{utils::executeProcess(executable, {"export", "from", from, nullptr},
+                                      [&](std::string_view chunk) { timewExport.feed(chunk); }, timeout)};
+    if (result.exitCode != 0) throw std::runtime_error("Failed to export timew intervals");
+    timewExport.finish();
+
+    return stats;
+}
@@ -0,0 +1,171 @@
+#include <vector>
+#include <cctype>
+#include <cstdlib>
+#include <algorithm>
+
+#include "TimewData.h"
+
+std::optional<std::chrono::system_clock::time_point> TimewData::parseTimestamp(std::string_view timestamp) noexcept {
+    if (timestamp.size() < 16 || timestamp[8] != 'T' || timestamp[15] != 'Z') return std::nullopt;
+
+    auto number = [&](std::size_t pos, std::size_t count) -> int {
+        auto value{0};
+        for (auto i{pos}; i < pos + count; ++i) {
+            if (timestamp[i] < '0' || timestamp[i] > '9') return -1;
+            value = value * 10 + (timestamp[i] - '0');
+        }
+        return value;
+    };
+
+    auto year{number(0, 4)}, month{number(4, 2)}, day{number(6, 2)};
+    auto hours{number(9, 2)}, minutes{number(11, 2)}, seconds{number(13, 2)};
+    if (year < 0 || month < 0 || day < 0 || hours < 0 || minutes < 0 || seconds < 0) return std::nullopt;
+
+    std::chrono::year_month_day date{std::chrono::year(year), std::chrono::month(month), std::chrono::day(day)};
+    if (!date.ok()) return std::nullopt;
+
+    return std::chrono::sys_days(date) + std::chrono::hours(hours) + std::chrono::minutes(minutes) +
+           std::chrono::seconds(seconds);
+}
+
+TimewData::TimewData(const std::string &path) : file_(path) {}
+
+std::filesystem::path TimewData::dataDirectory() {
+    std::error_code error;
+    if (auto db{std::getenv("TIMEWARRIORDB")}; db != nullptr) {
+        std::filesystem::path path{db};
+        return std::filesystem::is_directory(path / "data", error) ? path / "data" : std::filesystem::path{};
+    }
+
+    auto home{std::getenv("HOME")};
+    if (home == nullptr) return {};
+
+    std::filesystem::path legacy{std::filesystem::path(home) / ".timewarrior" / "data"};
+    if (std::filesystem::is_directory(legacy, error)) return legacy;
+
+    auto xdgDataHome{std::getenv("XDG_DATA_HOME")};
+    std::filesystem::path xdg{xdgDataHome != nullptr && *xdgDataHome != '\0'
+                              ? std::filesystem::path(xdgDataHome) / "timewarrior" / "data"
+                              : std::filesystem::path(home) / ".local" / "share" / "timewarrior" / "data"};
+    return std::filesystem::is_directory(xdg, error) ? xdg : std::filesystem::path{};
+}
+
+std::filesystem::path TimewData::latestFile() {
+    auto directory{dataDirectory()};
+    if (directory.empty()) return {};
+
+    std::error_code error;
+    std::vector<std::filesystem::path> files;
+    for (const auto &entry: std::filesystem::directory_iterator(directory, error)) {
+        auto name{entry.path().filename().string()};
+        // YYYY-MM.data, skips tags.data and undo.data
+        if (name.size() == 12 && name[4] == '-' && entry.path().extension() == ".data" &&
+            entry.file_size(error) != 0)
+            files.push_back(entry.path());
+    }
+
+    if (files.empty()) return {};
+    return *std::max_element(files.begin(), files.end());
+}
+
+std::optional<TimewInterval> TimewData::parseInterval(std::string_view line) noexcept {
+    if (line.substr(0, 4) != "inc ") return std::nullopt;
+    line.remove_prefix(4);
+
+    auto start{parseTimestamp(line)};
+    if (!start) return std::nullopt;
+    TimewInterval interval{*start, {}, {}};
+    line.remove_prefix(16);
+
+    if (line.substr(0, 3) == " - ") {
+        auto end{parseTimestamp(line.substr(3))};
+        if (!end) return std::nullopt;
+        interval.end = *end;
+        line.remove_prefix(19);
+    }
+
+    if (line.substr(0, 3) == " # ") {
+        line.remove_prefix(3);
+        // an annotation may follow the tags after another '#', which can also appear inside quoted tags
+        auto quoted{false};
+        for (auto i{0u}; i < line.size(); ++i) {
+            if (line[i] == '\\') {
+                ++i;
+            } else if (line[i] == '"') {
+                quoted = !quoted;
+            } else if (!quoted && line.substr(i, 3) == " # ") {
+                line = line.substr(0, i);
+                break;
+            }
+        }
+        interval.tags = line;
+    }
+
+    return interval;
+}
+
+std::optional<TimewInterval> TimewData::lastInterval() const noexcept {
+    auto content{file_.view()};
+    while (!content.empty() && std::isspace(static_cast<unsigned char>(content.back())))
+        content.remove_suffix(1);
+
+    auto lineStart{content.find_last_of('\n')};
+    return parseInterval(lineStart == std::string_view::npos ? content : content.substr(lineStart + 1));
+}
+
+std::chrono::seconds TimewData::trackedSince(std::chrono::system_clock::time_point since,
+                                             std::chrono::system_clock::time_point now) const noexcept {
+    std::chrono::seconds tracked{0};
+    auto content{file_.view()};
+    while (!content.empty()) {
+        auto lineStart{content.find_last_of('\n')};
+        auto interval{parseInterval(lineStart == std::string_view::npos ? content : content.substr(lineStart + 1))};
+        content = content.substr(0, lineStart == std::string_view::npos ? 0 : lineStart);
+        if (!interval) continue;
+
+        // the intervals are sorted, the ones before an interval ending before the point end before it too
+        auto end{interval->isOpen() ? now : std::min(interval->end, now)};
+        if (end <= since) break;
+        auto start{std::max(interval->start, since)};
+        if (end > start) tracked += std::chrono::duration_cast<std::chrono::seconds>(end - start);
+    }
+    return tracked;
+}
+
+std::string TimewData::formatTags(std::string_view tags) {
+    std::string formatted;
+    formatted.reserve(tags.size());
+    for (auto it{tags.begin()}; it < tags.end(); ++it) {
+        if (*it == '\\' && it + 1 < tags.end())
+            formatted.append(1, *++it);
+        else if (*it != '\\')
+            formatted.append(1, *it);
+    }
+    return formatted;
+}
+
+std::vector<std::string> TimewData::splitTags(std::string_view tags) {
+    std::vector<std::string> split;
+    std::string tag;
+    auto quoted{false}, inTag{false};
+
+    for (auto it{tags.begin()}; it < tags.end(); ++it) {
+        if (*it == '\\' && it + 1 < tags.end()) {
+            tag.append(1, *++it);
+            inTag = true;
+        } else if (*it == '"') {
+            quoted = !quoted;
+            inTag = true;
+        } else if (*it == ' ' && !quoted) {
+            if (inTag) split.push_back(std::move(tag));
+            tag.clear();
+            inTag = false;
+        } else {
+            tag.append(1, *it);
+            inTag = true;
+        }
+    }
+    if (inTag) split.push_back(std::move(tag));
+
+    return split;
+}
@@ -0,0 +1,188 @@
+#include <poll.h>
+#include <algorithm>
+#include <sys/wait.h>
+
+#include "TimewExecutor.h"
+
+/**
+ * Fails a timew command that exited with an error, timew prints the reason (e.g. "There is no active time tracking.")
+ * @param result the result of the command, its output holds stdout and stderr
+ * @throws std::runtime_error with the output of the command if it exited with an error
+ */
+static void checkExitCode(const utils::ProcessResult &result) noexcept(false) {
+    if (result.exitCode == 0) return;
+    auto end{result.output.find_last_not_of(" \t\r\n")};
+    if (end == std::string::npos)
+        throw std::runtime_error("timew failed with exit code " + std::to_string(result.exitCode));
+    throw std::runtime_error(result.output.substr(0, end + 1));
+}
+
+TimewExecutor::TimewExecutor(EventLoop &loop, Callback callback, std::chrono::milliseconds timeout)
+        : loop_(loop), callback_(std::move(callback)), timeout_(timeout) {
+    loop_.watch(timeoutTimer_.fd(), EPOLLIN, [this](uint32_t) {
+        if (!timeoutTimer_.expired() || !process_) return;
+        loop_.unwatch(process_->outputFd());
+        loop_.unwatch(process_->pidFd());
+        process_.reset();
+        complete({running_->command, false, "Timed out: " + std::string(Timew::executable), {}, {}});
+    });
+}
+
+TimewExecutor::~TimewExecutor() {
+    loop_.unwatch(timeoutTimer_.fd());
+
+    // a stop must not be lost on exit, the running command is given its timeout to finish
+    if (process_) {
+        loop_.unwatch(process_->outputFd());
+        loop_.unwatch(process_->pidFd());
+        pollfd fd{process_->outputFd(), POLLIN, 0};
+        bool outputOpen;
+        while ((outputOpen = process_->read(output_)) && ::poll(&fd, 1, static_cast<int>(timeout_.count())) > 0) {}
+        if (!outputOpen) process_->wait();
+        process_.reset();
+    }
+
+    for (const auto &pending: pending_) execute(pending.command);
+}
+
+void TimewExecutor::submit(TimewCommand command, Callback done) {
+    auto opposite{command == TimewCommand::STOP ? TimewCommand::RESUME :
+                  command == TimewCommand::RESUME ? TimewCommand::STOP : TimewCommand::NONE};
+
+    Pending *shared{nullptr};
+    if (command == TimewCommand::QUERY) {
+        auto query{std::find_if(pending_.begin(), pending_.end(),
+                                [](const Pending &p) { return p.command == TimewCommand::QUERY; })};
+        if (query != pending_.end()) shared = &*query;
+    } else if (!pending_.empty() && pending_.back().command == opposite) {
+        // e.g. a stop immediately followed by a continue leaves tracking as it is, both complete on the loop like
+        // any other command
+        loop_.post([cancelled = std::move(pending_.back()), command, done = std::move(done)] {
+            for (const auto &cancelledDone: cancelled.done) cancelledDone({cancelled.command, true, {}, {}, {}});
+            if (done) done({command, true, {}, {}, {}});
+        });
+        pending_.pop_back();
+        stats_.dropped += 2;
+        return;
+    } else if (!pending_.empty() && pending_.back().command == command) {
+        shared = &pending_.back();
+    }
+
+    if (shared == nullptr) {
+        shared = &pending_.emplace_back(Pending{command, {}});
+        loop_.post([this] { startNext(); });
+    } else {
+        ++stats_.merged;
+    }
+    if (done) shared->done.push_back(std::move(done));
+}
+
+const CoalesceStats &TimewExecutor::stats() const {
+    return stats_;
+}
+
+void TimewExecutor::startNext() {
+    if (running_ || pending_.empty()) return;
+    running_ = std::move(pending_.front());
+    pending_.pop_front();
+
+    // the data files answer a query without a process
+    if (running_->command == TimewCommand::QUERY) {
+        if (auto dataFile{TimewData::latestFile()}; !dataFile.empty()) {
+            Completion completion{TimewCommand::QUERY, true, {}, {}, {}};
+            try {
+                completion.query = Timew::queryData(dataFile);
+            } catch (const std::exception &error) {
+                completion.succeeded = false;
+                completion.error = error.what();
+            }
+            complete(std::move(completion));
+            return;
+        }
+    }
+
+    try {
+        process_ = std::make_unique<utils::ChildProcess>(Timew::executable, Timew::arguments(running_->command));
+    } catch (const std::exception &error) {
+        complete({running_->command, false, error.what(), {}, {}});
+        return;
+    }
+
+    output_.clear();
+    outputOpen_ = true;
+    exited_ = false;
+    loop_.watch(process_->outputFd(), EPOLLIN, [this](uint32_t) { readProcess(); });
+    if (process_->pidFd() != -1) {
+        loop_.watch(process_->pidFd(), EPOLLIN, [this](uint32_t) {
+            // the pidfd stays readable once the process exited
+            loop_.unwatch(process_->pidFd());
+            exited_ = true;
+            readProcess();
+        });
+    }
+    timeoutTimer_.arm(timeoutTimer_.now() + timeout_);
+}
+
+void TimewExecutor::readProcess() {
+    if (outputOpen_ && !process_->read(output_)) {
+        outputOpen_ = false;
+        loop_.unwatch(process_->outputFd());
+    }
+    // without a pidfd the process is reaped as soon as it closed its output
+    if (outputOpen_ || (!exited_ && process_->pidFd() != -1)) return;
+
+    timeoutTimer_.disarm();
+    auto status{process_->wait()};
+    process_.reset();
+
+    Completion completion{running_->command, true, {}, {}, {}};
+    try {
+        if (WEXITSTATUS(status) == 127) throw std::runtime_error("Failed to exec: " + std::string(Timew::executable));
+        utils::ProcessResult result{static_cast<uint8_t>(WEXITSTATUS(status)), std::move(output_)};
+        result.output.append(1, '\n');   // the same line end executeProcess adds
+        if (completion.command == TimewCommand::QUERY) {
+            completion.query = Timew::parseDom(result);
+        } else {
+            checkExitCode(result);
+            completion.process = std::move(result);
+        }
+    } catch (const std::exception &error) {
+        completion.succeeded = false;
+        completion.error = error.what();
+    }
+    complete(std::move(completion));
+}
+
+void TimewExecutor::complete(Completion completion) {
+    auto running{std::move(*running_)};
+    running_.reset();
+
+    callback_(completion);
+    for (const auto &done: running.done) done(completion);
+    startNext();
+}
+
+TimewExecutor::Completion TimewExecutor::execute(TimewCommand command) {
+    Completion completion{command, true, {}, {}, {}};
+    try {
+        switch (command) {
+            case TimewCommand::STOP:
+                completion.process = Timew::stop();
+                checkExitCode(completion.process);
+                break;
+            case TimewCommand::RESUME:
+                completion.process = Timew::resume();
+                checkExitCode(completion.process);
+                break;
+            case TimewCommand::QUERY:
+                completion.query = Timew::query();
+                break;
+            default:
+                throw std::logic_error("Unsupported timew command");
+        }
+    } catch (const std::exception &error) {
+        completion.succeeded = false;
+        completion.error = error.what();
+    }
+    return completion;
+}
@@ -0,0 +1,96 @@
+#include <ctime>
+#include <algorithm>
+
+#include "TimewData.h"
+#include "TimewExport.h"
+
+TimewExport::TimewExport(Callback callback) : callback_(std::move(callback)), parser_(*this) {}
+
+void TimewExport::feed(std::string_view chunk) {
+    parser_.feed(chunk);
+}
+
+void TimewExport::finish() {
+    parser_.finish();
+}
+
+void TimewExport::startObject() {
+    if (++depth_ == 2) interval_ = {};
+}
+
+void TimewExport::endObject() {
+    if (depth_-- == 2 && interval_.start != std::chrono::system_clock::time_point{}) callback_(interval_);
+}
+
+void TimewExport::startArray() {
+    ++depth_;
+}
+
+void TimewExport::endArray() {
+    --depth_;
+    field_ = Field::NONE;
+}
+
+void TimewExport::key(std::string_view key) {
+    // [ { "start": ..., "end": ..., "tags": [ ... ] } ]
+    if (depth_ != 2) return;
+    field_ = key == "start" ? Field::START : key == "end" ? Field::END : key == "tags" ? Field::TAGS : Field::NONE;
+}
+
+void TimewExport::string(std::string_view value) {
+    switch (field_) {
+        case Field::START:
+        case Field::END:
+            if (auto timestamp{TimewData::parseTimestamp(value)}; timestamp)
+                (field_ == Field::START ? interval_.start : interval_.end) = *timestamp;
+            field_ = Field::NONE;
+            break;
+        case Field::TAGS:
+            if (depth_ == 3) ++interval_.tagCount;
+            break;
+        case Field::NONE:
+            break;
+    }
+}
+
+/**
+ * Gets local midnight some days before a time point
+ */
+static std::chrono::system_clock::time_point localMidnight(std::chrono::system_clock::time_point time, int daysBefore) {
+    auto timeT{std::chrono::system_clock::to_time_t(time)};
+    std::tm local{};
+    localtime_r(&timeT, &local);
+    local.tm_mday -= daysBefore;    // normalized by mktime
+    local.tm_hour = local.tm_min = local.tm_sec = 0;
+    local.tm_isdst = -1;
+    return std::chrono::system_clock::from_time_t(std::mktime(&local));
+}
+
+FocusStats::FocusStats(std::chrono::system_clock::time_point now, std::chrono::seconds focusDuration)
+        : now(now), focusDuration(focusDuration) {
+    auto timeT{std::chrono::system_clock::to_time_t(now)};
+    std::tm local{};
+    localtime_r(&timeT, &local);
+    startOfToday = localMidnight(now, 0);
+    startOfWeek = localMidnight(now, (local.tm_wday + 6) % 7);
+}
+
+void FocusStats::add(const TimewExportInterval &interval) {
+    auto end{interval.end == std::chrono::system_clock::time_point{} ? now : std::min(interval.end, now)};
+
+    auto clipped = [&](std::chrono::system_clock::time_point from) {
+        auto start{std::max(interval.start, from)};
+        return end > start ? std::chrono::duration_cast<std::chrono::seconds>(end - start) : std::chrono::seconds(0);
+    };
+    auto pomodoros = [&](std::chrono::seconds focus) {
+        return focusDuration.count() > 0 ? static_cast<unsigned int>(focus / focusDuration) : 0u;
+    };
+
+    auto week{clipped(startOfWeek)};
+    weekFocus += week;
+    weekPomodoros += pomodoros(week);
+
+    auto today{clipped(startOfToday)};
+    todayFocus += today;
+    todayPomodoros += pomodoros(today);
+}
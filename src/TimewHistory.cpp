@@ -0,0 +1,260 @@
+#include <ctime>
+#include <atomic>
+#include <thread>
+#include <fstream>
+#include <algorithm>
+#include <sys/stat.h>
+
+#include "utils.h"
+#include "TimewData.h"
+#include "TimewHistory.h"
+
+static constexpr char indexMagic[4]{'T', 'W', 'P', 'I'};
+static constexpr uint32_t indexVersion{1};
+
+/**
+ * The header of the index of a month, the arrays of the month follow it
+ */
+struct IndexHeader {
+    char magic[4];
+    uint32_t version;
+    int64_t mtime;          // of the data file in nanoseconds
+    uint64_t size;          // of the data file
+    uint32_t intervalCount;
+    uint32_t tagCount;
+};
+
+TimewHistory TimewHistory::load(const std::filesystem::path &dataDirectory,
+                                const std::filesystem::path &indexDirectory) {
+    struct DataFile {
+        std::filesystem::path path;
+        int64_t mtime;
+        uint64_t size;
+    };
+
+    std::vector<DataFile> files;
+    std::error_code error;
+    for (const auto &entry: std::filesystem::directory_iterator(dataDirectory, error)) {
+        auto name{entry.path().filename().string()};
+        if (name.size() != 12 || name[4] != '-' || entry.path().extension() != ".data") continue;
+
+        struct stat fileStat{};
+        if (stat(entry.path().c_str(), &fileStat) == -1) continue;
+        files.push_back({entry.path(), fileStat.st_mtim.tv_sec * 1000000000ll + fileStat.st_mtim.tv_nsec,
+                         static_cast<uint64_t>(fileStat.st_size)});
+    }
+    std::sort(files.begin(), files.end(), [](const DataFile &a, const DataFile &b) { return a.path < b.path; });
+    if (!indexDirectory.empty()) std::filesystem::create_directories(indexDirectory, error);
+
+    // one month per task, the workers take the next month until there are none left
+    std::vector<Month> months(files.size());
+    std::vector<std::exception_ptr> errors(files.size());
+    std::atomic<std::size_t> next{0};
+    auto worker = [&] {
+        for (auto i{next++}; i < files.size(); i = next++) {
+            try {
+                auto indexFile{indexDirectory.empty() ? std::filesystem::path{} :
+                               indexDirectory / (files[i].path.stem().string() + ".idx")};
+                if (auto indexed{indexFile.empty() ? std::nullopt :
+                                 readIndex(indexFile, files[i].mtime, files[i].size)}; indexed) {
+                    months[i] = std::move(*indexed);
+                } else {
+                    months[i] = parseMonth(files[i].path);
+                    if (!indexFile.empty()) writeIndex(indexFile, months[i], files[i].mtime, files[i].size);
+                }
+            } catch (...) {
+                errors[i] = std::current_exception();
+            }
+        }
+    };
+
+    auto threadCount{std::min<std::size_t>(std::max(std::thread::hardware_concurrency(), 1u), files.size())};
+    std::vector<std::thread> threads;
+    for (auto i{1u}; i < threadCount; ++i) threads.emplace_back(worker);
+    worker();
+    for (auto &thread: threads) thread.join();
+
+    TimewHistory history;
+    for (auto i{0u}; i < months.size(); ++i) {
+        if (errors[i]) std::rethrow_exception(errors[i]);
+        history.append(months[i]);
+    }
+    return history;
+}
+
+TimewHistory::Month TimewHistory::parseMonth(const std::filesystem::path &dataFile) {
+    Month month;
+    utils::MappedFile file(dataFile);
+    auto content{file.view()};
+
+    while (!content.empty()) {
+        auto end{content.find('\n')};
+        auto line{content.substr(0, end)};
+        content.remove_prefix(end == std::string_view::npos ? content.size() : end + 1);
+
+        auto interval{TimewData::parseInterval(line)};
+        if (!interval) continue;
+
+        month.starts.push_back(std::chrono::duration_cast<std::chrono::seconds>(
+                interval->start.time_since_epoch()).count());
+        month.ends.push_back(interval->isOpen() ? 0 : std::chrono::duration_cast<std::chrono::seconds>(
+                interval->end.time_since_epoch()).count());
+
+        auto tags{TimewData::splitTags(interval->tags)};
+        month.tagCounts.push_back(static_cast<uint32_t>(tags.size()));
+        std::move(tags.begin(), tags.end(), std::back_inserter(month.tags));
+    }
+
+    return month;
+}
+
+std::optional<TimewHistory::Month>
+TimewHistory::readIndex(const std::filesystem::path &indexFile, int64_t mtime, uint64_t size) {
+    std::error_code error;
+    if (!std::filesystem::exists(indexFile, error)) return std::nullopt;
+
+    utils::MappedFile file(indexFile);
+    auto content{file.view()};
+
+    IndexHeader header{};
+    if (content.size() < sizeof(header)) return std::nullopt;
+    std::copy_n(content.data(), sizeof(header), reinterpret_cast<char *>(&header));
+    if (!std::equal(std::begin(indexMagic), std::end(indexMagic), header.magic) || header.version != indexVersion ||
+        header.mtime != mtime || header.size != size)
+        return std::nullopt;
+    content.remove_prefix(sizeof(header));
+
+    auto readArray = [&](auto &array, std::size_t count) {
+        using Tp = typename std::remove_reference_t<decltype(array)>::value_type;
+        if (content.size() < count * sizeof(Tp)) return false;
+        array.resize(count);
+        std::copy_n(content.data(), count * sizeof(Tp), reinterpret_cast<char *>(array.data()));
+        content.remove_prefix(count * sizeof(Tp));
+        return true;
+    };
+
+    Month month;
+    if (!readArray(month.starts, header.intervalCount) || !readArray(month.ends, header.intervalCount) ||
+        !readArray(month.tagCounts, header.intervalCount))
+        return std::nullopt;
+
+    month.tags.reserve(header.tagCount);
+    for (auto i{0u}; i < header.tagCount; ++i) {
+        uint32_t length;
+        if (content.size() < sizeof(length)) return std::nullopt;
+        std::copy_n(content.data(), sizeof(length), reinterpret_cast<char *>(&length));
+        content.remove_prefix(sizeof(length));
+        if (content.size() < length) return std::nullopt;
+        month.tags.emplace_back(content.substr(0, length));
+        content.remove_prefix(length);
+    }
+
+    return month;
+}
+
+void TimewHistory::writeIndex(const std::filesystem::path &indexFile, const Month &month, int64_t mtime,
+                              uint64_t size) {
+    IndexHeader header{{}, indexVersion, mtime, size, static_cast<uint32_t>(month.starts.size()),
+                       static_cast<uint32_t>(month.tags.size())};
+    std::copy(std::begin(indexMagic), std::end(indexMagic), header.magic);
+
+    // written next to the index and renamed over it, so a concurrent load never reads half of it
+    auto temporary{indexFile};
+    temporary += ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file) return;     // the index is only an optimization
+
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char *>(month.starts.data()),
+                   static_cast<std::streamsize>(month.starts.size() * sizeof(int64_t)));
+        file.write(reinterpret_cast<const char *>(month.ends.data()),
+                   static_cast<std::streamsize>(month.ends.size() * sizeof(int64_t)));
+        file.write(reinterpret_cast<const char *>(month.tagCounts.data()),
+                   static_cast<std::streamsize>(month.tagCounts.size() * sizeof(uint32_t)));
+        for (const auto &tag: month.tags) {
+            auto length{static_cast<uint32_t>(tag.size())};
+            file.write(reinterpret_cast<const char *>(&length), sizeof(length));
+            file.write(tag.data(), static_cast<std::streamsize>(tag.size()));
+        }
+        if (!file) return;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, indexFile, error);
+    if (error) std::filesystem::remove(temporary, error);
+}
+
+void TimewHistory::append(const Month &month) {
+    starts_.insert(starts_.end(), month.starts.begin(), month.starts.end());
+    ends_.insert(ends_.end(), month.ends.begin(), month.ends.end());
+
+    auto tag{month.tags.begin()};
+    for (auto tagCount: month.tagCounts) {
+        for (auto i{0u}; i < tagCount && tag != month.tags.end(); ++i, ++tag) {
+            auto [it, inserted]{tagIndex_.try_emplace(*tag, static_cast<uint32_t>(tagNames_.size()))};
+            if (inserted) tagNames_.push_back(*tag);
+            tagIds_.push_back(it->second);
+        }
+        tagOffsets_.push_back(static_cast<uint32_t>(tagIds_.size()));
+    }
+}
+
+std::size_t TimewHistory::size() const {
+    return starts_.size();
+}
+
+std::vector<std::pair<std::string, std::chrono::seconds>>
+TimewHistory::focusByTag(std::chrono::system_clock::time_point since,
+                         std::chrono::system_clock::time_point now) const {
+    auto sinceSeconds{std::chrono::duration_cast<std::chrono::seconds>(since.time_since_epoch()).count()};
+    auto nowSeconds{std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count()};
+
+    std::vector<int64_t> focus(tagNames_.size(), 0);
+    for (auto i{0u}; i < starts_.size(); ++i) {
+        auto start{std::max(starts_[i], sinceSeconds)};
+        auto end{std::min(ends_[i] == 0 ? nowSeconds : ends_[i], nowSeconds)};
+        if (end <= start) continue;
+        for (auto tag{tagOffsets_[i]}; tag < tagOffsets_[i + 1]; ++tag) focus[tagIds_[tag]] += end - start;
+    }
+
+    std::vector<std::pair<std::string, std::chrono::seconds>> byTag;
+    for (auto id{0u}; id < focus.size(); ++id) {
+        if (focus[id] > 0) byTag.emplace_back(tagNames_[id], std::chrono::seconds(focus[id]));
+    }
+    std::sort(byTag.begin(), byTag.end(), [](const auto &a, const auto &b) { return a.second > b.second; });
+    return byTag;
+}
+
+/**
+ * Numbers local days so that consecutive days have consecutive numbers
+ */
+static int64_t localDay(int64_t seconds) {
+    auto timeT{static_cast<std::time_t>(seconds)};
+    std::tm local{};
+    localtime_r(&timeT, &local);
+    std::chrono::year_month_day date{std::chrono::year(local.tm_year + 1900),
+                                     std::chrono::month(static_cast<unsigned int>(local.tm_mon + 1)),
+                                     std::chrono::day(static_cast<unsigned int>(local.tm_mday))};
+    return std::chrono::sys_days(date).time_since_epoch().count();
+}
+
+unsigned int TimewHistory::streak(std::chrono::system_clock::time_point now) const {
+    auto nowSeconds{std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count()};
+
+    std::vector<int64_t> days;
+    days.reserve(starts_.size());
+    for (auto i{0u}; i < starts_.size(); ++i) {
+        auto first{localDay(starts_[i])};
+        auto last{localDay(ends_[i] == 0 ? nowSeconds : ends_[i])};
+        for (auto day{first}; day <= last; ++day) days.push_back(day);
+    }
+    std::sort(days.begin(), days.end());
+    days.erase(std::unique(days.begin(), days.end()), days.end());
+
+    auto today{localDay(nowSeconds)};
+    auto day{std::binary_search(days.begin(), days.end(), today) ? today : today - 1};
+    auto streak{0u};
+    while (std::binary_search(days.begin(), days.end(), day--)) ++streak;
+    return streak;
+}
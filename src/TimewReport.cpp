@@ -0,0 +1,114 @@
+#include <algorithm>
+
+#include "TimewReport.h"
+
+/**
+ * Takes the next line off text
+ * @param text the text, the line and its line end are removed from it
+ * @return the line without the line end
+ */
+static std::string_view nextLine(std::string_view &text) noexcept {
+    auto end{text.find('\n')};
+    auto line{text.substr(0, end)};
+    text.remove_prefix(end == std::string_view::npos ? text.size() : end + 1);
+    return line;
+}
+
+static std::string_view trim(std::string_view text) noexcept {
+    auto start{text.find_first_not_of(" \t\r")};
+    if (start == std::string_view::npos) return {};
+    return text.substr(start, text.find_last_not_of(" \t\r") - start + 1);
+}
+
+std::optional<TimewReport> TimewReport::parse(std::string_view output) noexcept {
+    TimewReport report{false, {}, {}, {}, std::chrono::seconds(0)};
+
+    auto found{false};
+    while (!output.empty() && !found) {
+        auto line{nextLine(output)};
+        for (auto word: {std::string_view("Tracking"), std::string_view("Recorded")}) {
+            if (line.substr(0, word.size()) == word && (line.size() == word.size() || line[word.size()] == ' ')) {
+                report.isTracking = word == "Tracking";
+                report.tags = trim(line.substr(word.size()));
+                found = true;
+            }
+        }
+    }
+    if (!found) return std::nullopt;
+
+    auto hasTotal{false};
+    while (!output.empty() && !hasTotal) {
+        auto line{trim(nextLine(output))};
+        auto keyEnd{line.find(' ')};
+        if (keyEnd == std::string_view::npos) continue;
+
+        auto key{line.substr(0, keyEnd)};
+        auto value{trim(line.substr(keyEnd))};
+        if (key == "Started") {
+            report.started = value;
+        } else if (key == "Current" || key == "Ended") {
+            report.current = value;
+        } else if (key == "Total") {
+            auto total{parseDuration(value)};
+            if (!total) return std::nullopt;
+            report.total = *total;
+            hasTotal = true;
+        }
+    }
+
+    if (!hasTotal) return std::nullopt;
+    return report;
+}
+
+std::optional<std::chrono::seconds> TimewReport::parseDuration(std::string_view duration) noexcept {
+    long long fields[3]{0, 0, 0};   // hours, minutes, seconds
+    auto field{0u};
+    auto digits{0u};
+
+    for (auto c: duration) {
+        if (c >= '0' && c <= '9') {
+            if (++digits > 9) return std::nullopt;     // no overflow on absurd input
+            fields[field] = fields[field] * 10 + (c - '0');
+        } else if (c == ':' && digits != 0 && field < 2) {
+            ++field;
+            digits = 0;
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    if (field != 2 || digits == 0 || fields[1] > 59 || fields[2] > 59) return std::nullopt;
+    return std::chrono::seconds(fields[0] * 60 * 60 + fields[1] * 60 + fields[2]);
+}
+
+bool TimewReport::nextTag(std::string_view &tags, std::string_view &tag) noexcept {
+    auto start{tags.find_first_not_of(' ')};
+    if (start == std::string_view::npos) {
+        tags = {};
+        return false;
+    }
+    tags.remove_prefix(start);
+
+    if (tags.front() != '"') {
+        auto end{tags.find(' ')};
+        tag = tags.substr(0, end);
+        tags.remove_prefix(tag.size());
+        return true;
+    }
+
+    // a quoted tag ends at the first quote that isn't escaped
+    auto end{1u};
+    while (end < tags.size() && tags[end] != '"') end += tags[end] == '\\' ? 2 : 1;
+    tag = tags.substr(1, std::min<std::size_t>(end, tags.size()) - 1);
+    tags.remove_prefix(std::min<std::size_t>(end + 1, tags.size()));
+    return true;
+}
+
+std::string TimewReport::description() const {
+    std::string description;
+    description.reserve(tags.size());
+    for (auto c: tags) {
+        if (c != '\\') description.append(1, c);
+    }
+    return description;
+}
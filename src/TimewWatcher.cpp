@@ -0,0 +1,85 @@
+#include <climits>
+#include <unistd.h>
+#include <stdexcept>
+#include <sys/inotify.h>
+
+#include "TimewData.h"
+#include "TimewWatcher.h"
+
+TimewWatcher::TimewWatcher(EventLoop &loop, const std::filesystem::path &directory, Callback callback,
+                           std::chrono::milliseconds debounce)
+        : loop_(loop), callback_(std::move(callback)), debounce_(debounce) {
+    inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotifyFd_ == -1) throw std::runtime_error("Failed to initialize inotify");
+
+    // timew either rewrites the data files in place or renames a temporary file over them
+    if (inotify_add_watch(inotifyFd_, directory.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) == -1) {
+        close(inotifyFd_);
+        throw std::runtime_error("Failed to watch " + directory.string());
+    }
+
+    // the first change is compared against the state at startup
+    if (auto dataFile{TimewData::latestFile()}; !dataFile.empty()) {
+        if (auto interval{TimewData(dataFile).lastInterval()}; interval && interval->isOpen()) {
+            isTracking_ = true;
+            start_ = interval->start;
+        }
+    }
+
+    try {
+        loop_.watch(inotifyFd_, EPOLLIN, [this](uint32_t) { read(); });
+        loop_.watch(debounceTimer_.fd(), EPOLLIN, [this](uint32_t) {
+            // the burst of writes is over
+            if (debounceTimer_.expired()) update();
+        });
+    } catch (...) {
+        loop_.unwatch(inotifyFd_);
+        close(inotifyFd_);
+        throw;
+    }
+}
+
+TimewWatcher::~TimewWatcher() {
+    loop_.unwatch(debounceTimer_.fd());
+    loop_.unwatch(inotifyFd_);
+    close(inotifyFd_);
+}
+
+void TimewWatcher::read() {
+    alignas(inotify_event) char buf[sizeof(inotify_event) + NAME_MAX + 1];
+    auto pending{false};
+
+    ssize_t size;
+    while ((size = ::read(inotifyFd_, buf, sizeof(buf))) > 0) {
+        for (auto ptr{buf}; ptr < buf + size;) {
+            auto event{reinterpret_cast<inotify_event *>(ptr)};
+            ptr += sizeof(inotify_event) + event->len;
+            std::string_view name{event->len != 0 ? event->name : ""};
+            // only YYYY-MM.data files hold intervals
+            if (name.size() >= 12 && name[4] == '-' && name.substr(7, 5) == ".data") pending = true;
+        }
+    }
+
+    if (pending) debounceTimer_.arm(debounceTimer_.now() + debounce_);
+}
+
+void TimewWatcher::update() {
+    auto isTracking{false};
+    std::chrono::system_clock::time_point start{};
+
+    try {
+        if (auto dataFile{TimewData::latestFile()}; !dataFile.empty()) {
+            if (auto interval{TimewData(dataFile).lastInterval()}; interval && interval->isOpen()) {
+                isTracking = true;
+                start = interval->start;
+            }
+        }
+    } catch (const std::runtime_error &) {
+        return;     // the file was replaced while being read, the rename triggers another update
+    }
+
+    if (isTracking == isTracking_ && start == start_) return;
+    isTracking_ = isTracking;
+    start_ = start;
+    callback_(isTracking);
+}
@@ -0,0 +1,96 @@
+#include <bit>
+#include <cstring>
+#include <optional>
+#include <stdexcept>
+
+#include "WavReader.h"
+
+using utils::pcm::Encoding;
+
+static uint16_t littleEndian16(std::string_view bytes, std::size_t pos) {
+    uint16_t value;
+    std::memcpy(&value, bytes.data() + pos, sizeof(value));
+    return value;
+}
+
+static uint32_t littleEndian32(std::string_view bytes, std::size_t pos) {
+    uint32_t value;
+    std::memcpy(&value, bytes.data() + pos, sizeof(value));
+    return value;
+}
+
+static_assert(std::endian::native == std::endian::little, "the wav fields and samples are read as they are stored");
+
+std::string_view WavReader::Sound::samples() const {
+    if (mapping_) return mapped_;
+    return {reinterpret_cast<const char *>(converted_.data()), converted_.size() * sizeof(int16_t)};
+}
+
+WavReader::Sound WavReader::load(const std::string &audioFile) {
+    auto mapping{std::make_unique<utils::MappedFile>(audioFile)};
+    Format format{};
+    try {
+        format = parse(mapping->view());
+    } catch (const std::runtime_error &error) {
+        throw std::runtime_error(std::string(error.what()) + ": " + audioFile);
+    }
+
+    Sound sound;
+    sound.channels = format.channels;
+    sound.sampleRate = format.sampleRate;
+    if (format.encoding == Encoding::SIGNED_16) {
+        // OpenAL copies them straight from the file
+        sound.mapped_ = format.samples;
+        sound.mapping_ = std::move(mapping);
+    } else {
+        sound.converted_.resize(format.samples.size() / utils::pcm::sampleBytes(format.encoding));
+        utils::pcm::toSigned16(format.encoding, format.samples, sound.converted_.data());
+    }
+    return sound;
+}
+
+WavReader::Format WavReader::parse(std::string_view riff) {
+    if (riff.size() < 12 || riff.substr(0, 4) != "RIFF" || riff.substr(8, 4) != "WAVE")
+        throw std::runtime_error("Not a wav file");
+
+    // the size of the RIFF chunk is often wrong in recorded files, the chunks are walked to the end of the file
+    std::optional<std::string_view> fmt, data;
+    for (std::size_t pos{12}; pos + 8 <= riff.size() && !(fmt && data);) {
+        auto id{riff.substr(pos, 4)};
+        auto size{littleEndian32(riff, pos + 4)};
+        pos += 8;
+        // a truncated last chunk keeps what's there
+        auto body{riff.substr(pos, size)};
+        if (id == "fmt ") fmt = body;
+        else if (id == "data") data = body;
+        if (size > riff.size() - pos) break;
+        pos += size + (size & 1u);  // the chunks are padded to an even size
+    }
+    if (!fmt || fmt->size() < 16) throw std::runtime_error("Missing wav format");
+    if (!data) throw std::runtime_error("Missing wav samples");
+
+    auto formatTag{littleEndian16(*fmt, 0)};
+    auto channels{littleEndian16(*fmt, 2)};
+    auto sampleRate{littleEndian32(*fmt, 4)};
+    auto blockAlign{littleEndian16(*fmt, 12)};
+    auto bitsPerSample{littleEndian16(*fmt, 14)};
+    // WAVE_FORMAT_EXTENSIBLE, the format is the start of the sub format GUID
+    if (formatTag == 0xFFFE && fmt->size() >= 26) formatTag = littleEndian16(*fmt, 24);
+
+    Encoding encoding;
+    if (formatTag == 1 && bitsPerSample == 8) encoding = Encoding::UNSIGNED_8;
+    else if (formatTag == 1 && bitsPerSample == 16) encoding = Encoding::SIGNED_16;
+    else if (formatTag == 1 && bitsPerSample == 24) encoding = Encoding::SIGNED_24;
+    else if (formatTag == 1 && bitsPerSample == 32) encoding = Encoding::SIGNED_32;
+    else if (formatTag == 3 && bitsPerSample == 32) encoding = Encoding::FLOAT_32;
+    else
+        throw std::runtime_error("Unsupported wav encoding (format " + std::to_string(formatTag) + ", " +
+                                 std::to_string(bitsPerSample) + " bits)");
+
+    // OpenAL plays mono and stereo
+    if (channels != 1 && channels != 2) throw std::runtime_error("Unsupported wav channels");
+    if (sampleRate == 0 || blockAlign != channels * utils::pcm::sampleBytes(encoding))
+        throw std::runtime_error("Invalid wav format");
+
+    return {encoding, channels, sampleRate, data->substr(0, data->size() - data->size() % blockAlign)};
+}
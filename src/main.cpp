@@ -1,143 +1,179 @@
-#include <future>
 #include <iostream>
+#include <optional>
 #include <csignal>
+#include <string_view>
+#include <sys/ioctl.h>
 
-#include "utils.h"
-#include "Timew.h"
 #include "config.h"
 #include "Ncurses.h"
+#include "Pomodoro.h"
+#include "EventLoop.h"
+#include "TimewData.h"
+#include "TerminalView.h"
+#include "ControlSocket.h"
+#include "StatusSegment.h"
+#include "TimewWatcher.h"
 #include "sound/AudioPlayer.h"
 
-static constexpr int tmrScreenLines = 2;
-
-static utils::concurrent::queue<PomodoroSession<int64_t, std::nano>> taskQueue;
-static std::atomic<bool> isRunning = true, isPause = true;
-
-static auto usr1SigHandler(int) {
-    isPause.store(true, std::memory_order::relaxed);
-    taskQueue.push({std::chrono::minutes(25), std::chrono::minutes(5), TimewCommand::QUERY});
-}
-
-template<typename Rep, typename Period>
-static auto countDown(const Ncurses::Screen &tmrScreen, const Ncurses::Screen &cmdScreen, const std::string &title,
-                      const std::string &taskDescription, std::chrono::duration<Rep, Period> duration) {
-    std::chrono::duration<int64_t, std::nano> delta(0);
-    auto prevTime{std::chrono::steady_clock::now()};
-
-    auto running{isRunning.load(std::memory_order::relaxed)}, pause{isPause.load(std::memory_order::relaxed)};
-    while (running && !pause && duration.count() > 0) {
-        std::string secRep{utils::formatSeconds<Rep, Period>(duration)};
-        tmrScreen.putCentered(title, 0, static_cast<int>(title.size()));
-        tmrScreen.putCentered(secRep, 1, static_cast<int>(secRep.size()));
-        cmdScreen.putCentered(taskDescription, cmdScreen.getLines() - 2, cmdScreen.getCols() - 11);
-        auto sleepTime{std::chrono::seconds(1) - delta};
-        std::this_thread::sleep_for(sleepTime);
-        auto curTime{std::chrono::steady_clock::now()};
-        auto timeSlept{curTime - prevTime};
-        delta = (timeSlept - sleepTime) % std::chrono::seconds(1);
-        duration -= timeSlept;
-        prevTime = curTime;
-        running = isRunning.load(std::memory_order::relaxed);
-        pause = isPause.load(std::memory_order::relaxed);
-    }
-
-    return running && !pause;
-}
-
-auto main() -> int {
+/**
+ * What a run saved by coalescing commands and what it wrote to the terminal, printed with --stats
+ */
+struct RunStats {
+    CoalesceStats coalesced;
+    Ncurses::FrameStats frames;
+};
+
+/**
+ * Runs the pomodoro until the user exits, or until SIGINT or SIGTERM
+ * @param headless whether to run without the terminal interface, publishing the status only
+ * @param focusTrack an ogg file looped during the focus count downs, or empty
+ * @param stats set to what the run saved and wrote, or nullptr
+ */
+static void run(bool headless, const std::string &focusTrack, RunStats *stats) {
+    EventLoop loop;
     AudioPlayer audioPlayer;            // handle initialization of audio player
-    Ncurses ncurses;                    // handle initialization of ncurses
-    Ncurses::Screen cmdScreen(stdscr);
-    Ncurses::Screen tmrScreen(tmrScreenLines, COLS, 2, 0);
-
-    std::thread worker([&] {
-        audioPlayer.load(PROJECT_INSTALL_PREFIX "/share/" PROJECT_NAME "/sounds/Synth_Brass.ogg");
-        audioPlayer.load(PROJECT_INSTALL_PREFIX "/share/" PROJECT_NAME "/sounds/Retro_Synth.ogg");
+    std::optional<TerminalView> view;
+    if (!headless) view.emplace(loop);
+
+    // status bars read the session from the segment, a second instance runs without it
+    std::optional<StatusSegment> status;
+    try {
+        status.emplace();
+    } catch (const std::runtime_error &error) {
+        if (headless) throw;
+        view->toast(error.what(), std::chrono::seconds(2));
+    }
 
-        while (isRunning.load(std::memory_order_relaxed)) {
-            auto task{taskQueue.wait_pop()};
-            if (task.timewCommand == TimewCommand::NONE) break;
+    Pomodoro pomodoro(loop, view ? &*view : nullptr, status ? &*status : nullptr, audioPlayer, focusTrack);
+
+    loop.watchSignals({SIGUSR1, SIGWINCH, SIGINT, SIGTERM}, [&](int signal) {
+        if (signal == SIGUSR1) {
+            pomodoro.push({std::chrono::minutes(25), std::chrono::minutes(5), TimewCommand::QUERY});
+        } else if (signal == SIGINT || signal == SIGTERM) {
+            loop.stop();
+        } else if (winsize size{}; view && ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0) {
+            // ncurses never sees SIGWINCH since it's blocked
+            resizeterm(size.ws_row, size.ws_col);
+            view->resize();
+        }
+    });
 
-            isPause.store(false, std::memory_order_relaxed);
-            cmdScreen.clear();
-            PUT_CENTERED(cmdScreen, "commands: (c)ontinue, (p)ause, (e)xit", 0);
+    // hooks and scripts drive this instance only, a second instance runs without the socket
+    std::optional<ControlSocket> control;
+    try {
+        control.emplace(loop, ControlSocket::defaultPath(), [&](ControlCommand command) -> std::string {
+            switch (command) {
+                case ControlCommand::START:
+                    pomodoro.push({std::chrono::minutes(25), std::chrono::minutes(5), TimewCommand::QUERY});
+                    break;
+                case ControlCommand::CONTINUE:
+                    if (!pomodoro.isPaused()) return "error: Timer is already running";
+                    pomodoro.push({std::chrono::minutes(25), std::chrono::minutes(5), TimewCommand::RESUME});
+                    break;
+                case ControlCommand::PAUSE:
+                    pomodoro.pause();
+                    break;
+                case ControlCommand::STATUS:
+                    return StatusSegment::format(pomodoro.status());
+                case ControlCommand::QUIT:
+                    loop.stop();
+                    break;
+            }
+            return "ok";
+        });
+    } catch (const std::runtime_error &error) {
+        if (headless) throw;
+        pomodoro.report(error.what());
+    }
 
-            auto timewQuery = Timew::query();
-            std::string taskDescription{std::move(timewQuery.taskDescription)};
-            std::chrono::duration<int64_t, std::nano> focusDuration{task.focusDuration};
+    // picks up tracking started by any tool, the hook script is only needed where inotify isn't available
+    std::optional<TimewWatcher> watcher;
+    if (auto dataDirectory{TimewData::dataDirectory()}; !dataDirectory.empty()) {
+        try {
+            watcher.emplace(loop, dataDirectory, [&](bool isTracking) { pomodoro.trackingChanged(isTracking); });
+        } catch (const std::runtime_error &error) {
+            pomodoro.report(error.what());
+        }
+    }
 
-            try {
-                if (task.timewCommand == TimewCommand::RESUME) {
-                    if (timewQuery.isTracking) {
-                        if (timewQuery.trackedTime > task.focusDuration)
-                            focusDuration = std::chrono::duration<long, std::nano>(0);
-                        else
-                            focusDuration = task.focusDuration - timewQuery.trackedTime;
-                    } else {
-                        taskDescription = utils::formatDescription(Timew::resume().output);
-                    }
+    if (view) {
+        view->input().setNonBlocking(true);
+        loop.watch(STDIN_FILENO, EPOLLIN, [&](uint32_t) {
+            int cmdChar;
+            while ((cmdChar = view->input().getCharToLower()) != ERR) {
+                switch (cmdChar) {
+                    case 'c':
+                        if (pomodoro.isPaused()) {
+                            pomodoro.push({std::chrono::minutes(25), std::chrono::minutes(5), TimewCommand::RESUME});
+                        } else {
+                            view->toast("Timer is already running", std::chrono::seconds(1));
+                        }
+                        break;
+                    case 'p':
+                        pomodoro.pause();
+                        break;
+                    case 'e':
+                        loop.stop();
+                        return;
+                    case KEY_RESIZE:
+                        view->resize();
+                        break;
+                    default:
+                        break;
                 }
-            } catch (const std::runtime_error &error) {
-                cmdScreen.putFor(error.what(), cmdScreen.getLines() - 1, 0, std::chrono::seconds(2));
-                isPause.store(true, std::memory_order_relaxed);
-                continue;
             }
+        });
+    }
 
-            if (!countDown(tmrScreen, cmdScreen, "Focus!", taskDescription, focusDuration)) continue;
-
-            try {
-                audioPlayer.play(PROJECT_INSTALL_PREFIX "/share/" PROJECT_NAME "/sounds/Retro_Synth.ogg");
-                Timew::stop();
-            } catch (const std::runtime_error &error) {
-                cmdScreen.putFor(error.what(), cmdScreen.getLines() - 1, 0, std::chrono::seconds(2));
-            }
+    loop.run();
+    if (view) loop.unwatch(STDIN_FILENO);
 
-            if (!countDown(tmrScreen, cmdScreen, "Break", taskDescription, task.breakDuration)) continue;
+    if (stats) *stats = {pomodoro.coalesced(), Ncurses::frameStats()};
+}
 
-            isPause.store(true, std::memory_order_relaxed);
-            audioPlayer.play(PROJECT_INSTALL_PREFIX "/share/" PROJECT_NAME "/sounds/Synth_Brass.ogg");
+auto main(int argc, char *argv[]) -> int {
+    bool headless{false}, printStats{false};
+    std::string focusTrack;
+    for (auto i{1}; i < argc; ++i) {
+        std::string_view option{argv[i]};
+        if (option == "--headless") {
+            headless = true;
+        } else if (option == "--focus-track" && i + 1 < argc) {
+            focusTrack = argv[++i];
+        } else if (option == "--stats") {
+            printStats = true;
+        } else {
+            std::cerr << "usage: " PROJECT_NAME " [--headless] [--focus-track FILE] [--stats]\n"
+                         "  --headless            run without the terminal interface, the status is read with "
+                         PROJECT_NAME "-status\n"
+                         "  --focus-track FILE    loop an ogg file during the focus sessions, streamed from the "
+                         "disk\n"
+                         "  --stats               print the coalesced commands and the terminal output on exit\n";
+            return 2;
         }
-    });
-
-    struct sigaction sa{.sa_flags = SA_RESTART | SA_NOCLDSTOP};
-    sa.sa_handler = usr1SigHandler;
-    if (sigaction(SIGUSR1, &sa, nullptr) == EINVAL) {
-        cmdScreen.putFor("Unable to handle signals", cmdScreen.getLines() - 1, 0, std::chrono::seconds(1));
     }
 
-    int cmdChar;
-    PUT_CENTERED(cmdScreen, "commands: (c)ontinue, (p)ause, (e)xit", 0);
-    while ((cmdChar = cmdScreen.getCharToLower()) != 'e') {
-        switch (cmdChar) {
-            case 'c':
-                if (isPause.load(std::memory_order::relaxed)) {
-                    taskQueue.push({std::chrono::minutes(25), std::chrono::minutes(5), TimewCommand::RESUME});
-                } else {
-                    cmdScreen.putFor("Timer is already running", cmdScreen.getLines() - 1, 0, std::chrono::seconds(1));
-                }
-                break;
-            case 'p':
-                isPause.store(true, std::memory_order_relaxed);
-                try {
-                    Timew::stop();
-                } catch (const std::runtime_error &error) {}
-                break;
-            case KEY_RESIZE:
-                int lines, cols;
-                getmaxyx(stdscr, lines, cols);
-                cmdScreen.resize(lines, cols);
-                tmrScreen.resize(tmrScreenLines, cols);
-                PUT_CENTERED(cmdScreen, "commands: (c)ontinue, (p)ause, (e)xit", 0);
-                break;
-            default:
-                break;
+    // blocked before the audio and ncurses start any thread, so that the signals only reach the signalfd
+    EventLoop::blockSignals({SIGUSR1, SIGWINCH, SIGINT, SIGTERM});
+
+    // reported once ncurses gave the terminal back
+    std::optional<RunStats> stats;
+    if (printStats) stats.emplace();
+    try {
+        run(headless, focusTrack, stats ? &*stats : nullptr);
+    } catch (const std::runtime_error &error) {
+        std::cerr << PROJECT_NAME ": " << error.what() << '\n';
+        return 1;
+    }
+    if (stats) {
+        std::cerr << stats->coalesced.merged << " commands merged and " << stats->coalesced.dropped
+                  << " dropped instead of running\n";
+        std::cerr << stats->frames.frames << " frames wrote " << stats->frames.bytes << " bytes to the terminal";
+        if (stats->frames.frames != 0) {
+            std::cerr << " (" << stats->frames.bytes / stats->frames.frames << " per frame, at most "
+                      << stats->frames.maxFrameBytes << ")";
         }
-        flushinp();
+        std::cerr << '\n';
     }
-
-    isRunning.store(false, std::memory_order_relaxed);  // not used for synchronization
-    taskQueue.push({});    // necessary since the thread waits on the queue
-    worker.join();
-
     return 0;
 }
@@ -25,7 +25,12 @@ OpenSlAudioPlayer::~OpenSlAudioPlayer() {
     (*slEngineObj_)->Destroy(slEngineObj_);
 }
 
-void OpenSlAudioPlayer::load(const std::string &audioFile) {
+void OpenSlAudioPlayer::load(SoundId sound) {
+    auto &player{audio_[assets::index(sound)]};
+    if (player == nullptr) player = createPlayer(std::string(assets::file(sound)), false);
+}
+
+SLPlayItf OpenSlAudioPlayer::createPlayer(const std::string &audioFile, bool loop) {
     SLresult result;
     // configure audio source
     SLDataLocator_URI slDataLocatorUri = {SL_DATALOCATOR_URI, (SLchar *) audioFile.c_str()};
@@ -59,16 +64,30 @@ void OpenSlAudioPlayer::load(const std::string &audioFile) {
     SLSeekItf audioPlayerSeekItf;
     result = (*slAudioPlayerObj_)->GetInterface(slAudioPlayerObj_, SL_IID_SEEK, &audioPlayerSeekItf);
     assert(SL_RESULT_SUCCESS == result);
-    result = (*audioPlayerSeekItf)->SetLoop(audioPlayerSeekItf, (SLboolean) false, 0, SL_TIME_UNKNOWN);
+    result = (*audioPlayerSeekItf)->SetLoop(audioPlayerSeekItf, (SLboolean) loop, 0, SL_TIME_UNKNOWN);
     assert(SL_RESULT_SUCCESS == result);
 
     SLPlayItf audioPlayerPlayItf;
     result = (*slAudioPlayerObj_)->GetInterface(slAudioPlayerObj_, SL_IID_PLAY, &audioPlayerPlayItf);
     assert(SL_RESULT_SUCCESS == result);
-    audio_[audioFile] = audioPlayerPlayItf;
+    return audioPlayerPlayItf;
+}
+
+void OpenSlAudioPlayer::play(SoundId sound) const noexcept(true) {
+    auto player{audio_[assets::index(sound)]};
+    if (player == nullptr) return;
+    (*player)->SetPlayState(player, SL_PLAYSTATE_STOPPED);
+    (*player)->SetPlayState(player, SL_PLAYSTATE_PLAYING);
+}
+
+void OpenSlAudioPlayer::stream(const std::string &audioFile, bool loop) {
+    auto it{streams_.find(audioFile)};
+    if (it == streams_.end()) it = streams_.emplace(audioFile, createPlayer(audioFile, loop)).first;
+    (*it->second)->SetPlayState(it->second, SL_PLAYSTATE_STOPPED);
+    (*it->second)->SetPlayState(it->second, SL_PLAYSTATE_PLAYING);
 }
 
-void OpenSlAudioPlayer::play(const std::string &audioFile) const noexcept(true) {
-    (*audio_.at(audioFile))->SetPlayState(audio_.at(audioFile), SL_PLAYSTATE_STOPPED);
-    (*audio_.at(audioFile))->SetPlayState(audio_.at(audioFile), SL_PLAYSTATE_PLAYING);
+void OpenSlAudioPlayer::stop(const std::string &audioFile) const noexcept(true) {
+    auto it{streams_.find(audioFile)};
+    if (it != streams_.end()) (*it->second)->SetPlayState(it->second, SL_PLAYSTATE_STOPPED);
 }
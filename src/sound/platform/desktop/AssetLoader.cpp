@@ -0,0 +1,65 @@
+#include <string>
+#include <algorithm>
+#include <stdexcept>
+
+#include "sound/platform/desktop/AssetLoader.h"
+
+AssetLoader::AssetLoader(PcmCache &cache, unsigned int threads) : cache_(cache) {
+    for (auto i{0u}; i < std::max(threads, 1u); ++i)
+        workers_.emplace_back([this](std::stop_token stop) { work(stop); });
+}
+
+AssetLoader::~AssetLoader() {
+    for (auto &worker: workers_) worker.request_stop();
+    workers_.clear();   // joins, before the assets the workers decode go away
+}
+
+void AssetLoader::add(SoundId sound, bool lazy) {
+    std::lock_guard lock(mutex_);
+    auto &asset{assets_[assets::index(sound)]};
+    if (asset.added) return;
+    asset.added = true;
+
+    asset.decode = std::packaged_task<PcmCache::Sound()>([this, sound] {
+        std::string file{assets::file(sound)};
+        auto embedded{assets::embedded(sound)};
+        return embedded.empty() ? cache_.load(file) : PcmCache::decodeMemory(embedded, file);
+    });
+    asset.decoded = asset.decode.get_future();
+    if (lazy) return;
+
+    asset.started = true;
+    queue_.push_back(&asset);
+    queued_.notify_one();
+}
+
+PcmCache::Sound AssetLoader::take(SoundId sound) {
+    std::unique_lock lock(mutex_);
+    auto &asset{assets_[assets::index(sound)]};
+    if (!asset.added) throw std::runtime_error("Sound wasn't loaded: " + std::string(assets::file(sound)));
+    if (!asset.decoded.valid())
+        throw std::runtime_error("Sound was taken already: " + std::string(assets::file(sound)));
+
+    auto decoded{std::move(asset.decoded)};
+    if (!asset.started) {
+        asset.started = true;
+        lock.unlock();
+        asset.decode();     // no worker runs a task it wasn't queued
+    } else {
+        lock.unlock();
+    }
+    return decoded.get();
+}
+
+void AssetLoader::work(std::stop_token stop) {
+    while (true) {
+        std::unique_lock lock(mutex_);
+        if (!queued_.wait(lock, stop, [this] { return !queue_.empty(); })) return;
+        auto asset{queue_.front()};
+        queue_.pop_front();
+        lock.unlock();
+
+        // a failed decoding is kept in the future and thrown to the thread that takes the sound
+        asset->decode();
+    }
+}
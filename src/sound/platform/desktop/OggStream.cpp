@@ -0,0 +1,109 @@
+#include <cstdio>
+#include <stdexcept>
+
+#include "sound/platform/desktop/OggStream.h"
+
+OggStream::OggStream(const std::string &oggFile, bool loop) : loop_(loop) {
+    auto dataSource{std::fopen(oggFile.c_str(), "rb")};
+    if (dataSource == nullptr) throw std::runtime_error("Failed to open file: " + oggFile);
+
+    // the vorbis file closes the data source once it's opened
+    if (ov_open_callbacks(dataSource, &vorbisFile_, nullptr, 0, OV_CALLBACKS_DEFAULT) < 0) {
+        std::fclose(dataSource);
+        throw std::runtime_error("Failed to open ogg file: " + oggFile);
+    }
+    auto vorbisInfo{ov_info(&vorbisFile_, -1)};
+    if (vorbisInfo->channels != 1 && vorbisInfo->channels != 2) {
+        ov_clear(&vorbisFile_);
+        throw std::runtime_error("Unsupported ogg channels: " + oggFile);
+    }
+    format_ = vorbisInfo->channels == 1 ? AL_FORMAT_MONO16 : AL_FORMAT_STEREO16;
+    sampleRate_ = static_cast<ALsizei>(vorbisInfo->rate);
+
+    alGetError();
+    alGenSources(1, &source_);
+    alGenBuffers(bufferCount, buffers_);
+    if (alGetError() != AL_NO_ERROR) {
+        if (alIsSource(source_)) alDeleteSources(1, &source_);
+        ov_clear(&vorbisFile_);
+        throw std::runtime_error("Failed to create a stream for: " + oggFile);
+    }
+    alSourcei(source_, AL_LOOPING, AL_FALSE);    // the loop is decoded, a looping source would repeat a buffer
+
+    // the whole ring is queued before playing, a short file queues fewer buffers
+    auto queued{0};
+    for (; queued < bufferCount; ++queued) {
+        auto size{decode()};
+        if (size == 0) break;
+        alBufferData(buffers_[queued], format_, pcm_.data(), static_cast<ALsizei>(size), sampleRate_);
+    }
+    alSourceQueueBuffers(source_, queued, buffers_);
+    alSourcePlay(source_);
+
+    thread_ = std::jthread([this](std::stop_token stop) { refill(stop); });
+}
+
+OggStream::~OggStream() {
+    thread_.request_stop();
+    timer_.wake();
+    if (thread_.joinable()) thread_.join();
+
+    // stopping marks every queued buffer processed so that they all unqueue
+    alSourceStop(source_);
+    alSourcei(source_, AL_BUFFER, 0);
+    alDeleteSources(1, &source_);
+    alDeleteBuffers(bufferCount, buffers_);
+    ov_clear(&vorbisFile_);
+}
+
+bool OggStream::finished() const {
+    return finished_;
+}
+
+std::size_t OggStream::decode() {
+    std::size_t used{0};
+    auto rewound{false};
+    while (used < pcm_.size()) {
+        auto size{ov_read(&vorbisFile_, pcm_.data() + used, static_cast<int>(pcm_.size() - used), 0, 2, 1, nullptr)};
+        if (size > 0) {
+            used += static_cast<std::size_t>(size);
+            rewound = false;
+        } else if (size == OV_HOLE) {
+            continue;
+        } else if (size == 0 && loop_ && !rewound && ov_pcm_seek(&vorbisFile_, 0) == 0) {
+            // the start of the file goes on in the same buffer, so the loop has no gap, an empty file ends
+            rewound = true;
+        } else {
+            break;
+        }
+    }
+    return used;
+}
+
+void OggStream::refill(const std::stop_token &stop) {
+    while (!stop.stop_requested()) {
+        if (!timer_.waitUntil(timer_.now() + refillPeriod)) continue;
+
+        ALint processed{0};
+        alGetSourcei(source_, AL_BUFFERS_PROCESSED, &processed);
+        for (; processed > 0; --processed) {
+            ALuint buffer;
+            alSourceUnqueueBuffers(source_, 1, &buffer);
+            auto size{decode()};
+            if (size == 0) continue;    // the end, the buffer stays out of the ring
+            alBufferData(buffer, format_, pcm_.data(), static_cast<ALsizei>(size), sampleRate_);
+            alSourceQueueBuffers(source_, 1, &buffer);
+        }
+
+        ALint state, queued;
+        alGetSourcei(source_, AL_SOURCE_STATE, &state);
+        alGetSourcei(source_, AL_BUFFERS_QUEUED, &queued);
+        if (state == AL_PLAYING) continue;
+        if (queued == 0) {
+            finished_ = true;
+            return;
+        }
+        // the source ran out of buffers before they were refilled, it restarts with the ones queued since
+        alSourcePlay(source_);
+    }
+}
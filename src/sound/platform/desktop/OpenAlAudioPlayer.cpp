@@ -1,8 +1,10 @@
-#include <fstream>
+#include <thread>
 #include <vector>
-#include <vorbis/vorbisfile.h>
+#include <fstream>
+#include <algorithm>
 
 #include "utils.h"
+#include "WavReader.h"
 #include "sound/platform/desktop/OpenAlAudioPlayer.h"
 
 #define alCall(function, ...) alCallImpl(__FILE__, __LINE__, function, __VA_ARGS__)
@@ -116,7 +118,13 @@ static inline unsigned int getAlAudioFormat(unsigned int channel, unsigned int b
     }
 }
 
-OpenAlAudioPlayer::OpenAlAudioPlayer() : openALDevice_{alcOpenDevice(nullptr)} {
+OpenAlAudioPlayer::OpenAlAudioPlayer()
+        : openALDevice_{alcOpenDevice(nullptr)},
+          cache_([] {
+              auto directory{utils::cacheDirectory()};
+              return directory.empty() ? directory : directory / "sounds";
+          }()),
+          loader_(cache_, std::clamp(std::thread::hardware_concurrency(), 1u, 4u)) {
     if (openALDevice_ == nullptr) throw std::runtime_error("Failed to initialize AL Device");
 
     alcCall(alcCreateContext, openALContext_, openALDevice_, openALDevice_, nullptr);
@@ -127,17 +135,66 @@ OpenAlAudioPlayer::OpenAlAudioPlayer() : openALDevice_{alcOpenDevice(nullptr)} {
 }
 
 OpenAlAudioPlayer::~OpenAlAudioPlayer() {
+    streams_.clear();   // their sources go with the context
     alcCall(alcMakeContextCurrent, contextCurrent_, openALDevice_, nullptr);
     alcCall(alcDestroyContext, openALDevice_, openALContext_);
     ALCboolean closed;
     alcCall(alcCloseDevice, closed, openALDevice_, openALDevice_);
 }
 
-void OpenAlAudioPlayer::load(const std::string &audioFile) {
+void OpenAlAudioPlayer::load(SoundId id, bool lazy) {
+    std::string audioFile{assets::file(id)};
     auto extension = audioFile.substr(audioFile.find_last_of('.'));
-    auto dataSource = fopen(audioFile.c_str(), "rb");
-    if (dataSource == nullptr) throw std::runtime_error("Failed to open file: " + audioFile);
+    auto &sound{audio_[assets::index(id)]};
+    if (sound.loaded) return;
+
+    if (extension == ".ogg") {
+        // decoded on the pool, or on the first play if lazy, and uploaded by the first play
+        loader_.add(id, lazy);
+    } else if (extension == ".wav") {
+        // the samples are converted to 16 bits, or uploaded straight from the mapped file if they are already
+        auto wav{WavReader::load(audioFile)};
+        auto samples{wav.samples()};
+        sound.source = upload(getAlAudioFormat(wav.channels, 16), samples.data(), static_cast<ALsizei>(samples.size()),
+                              static_cast<ALsizei>(wav.sampleRate));
+    } else {
+        throw std::runtime_error("Unsupported audio format (" + extension + ")");
+    }
+    sound.loaded = true;
+}
+
+void OpenAlAudioPlayer::play(SoundId id) noexcept(true) {
+    auto &sound{audio_[assets::index(id)]};
+    if (!sound.loaded || sound.failed) return;
+
+    if (sound.source == 0) {
+        try {
+            // waits for this sound only, OpenAL copies the samples, straight from the mapped cache entry once the
+            // file was decoded before
+            auto decoded{loader_.take(id)};
+            auto samples{decoded.samples()};
+            sound.source = upload(getAlAudioFormat(decoded.channels, 16), samples.data(),
+                                  static_cast<ALsizei>(samples.size()), static_cast<ALsizei>(decoded.sampleRate));
+        } catch (const std::runtime_error &error) {
+            std::cerr << error.what() << std::endl;
+            sound.failed = true;
+            return;
+        }
+    }
+    alCall(alSourcePlay, sound.source);
+}
 
+void OpenAlAudioPlayer::stream(const std::string &audioFile, bool loop) {
+    std::erase_if(streams_, [](const auto &entry) { return entry.second->finished(); });
+    streams_.erase(audioFile);
+    streams_.emplace(audioFile, std::make_unique<OggStream>(audioFile, loop));
+}
+
+void OpenAlAudioPlayer::stop(const std::string &audioFile) {
+    streams_.erase(audioFile);
+}
+
+ALuint OpenAlAudioPlayer::upload(ALenum format, const ALvoid *samples, ALsizei size, ALsizei sampleRate) {
     ALuint alSource;
     alCall(alGenSources, 1, &alSource);
     alCall(alSourcef, alSource, AL_PITCH, 1.0f);
@@ -148,31 +205,7 @@ void OpenAlAudioPlayer::load(const std::string &audioFile) {
     ALuint alBuffer;
     alCall(alGenBuffers, 1, &alBuffer);
 
-    if (extension == ".ogg") {
-        OggVorbis_File vorbisFile;
-        ov_open_callbacks(dataSource, &vorbisFile, nullptr, -1, OV_CALLBACKS_DEFAULT);
-        auto vorbisInfo = ov_info(&vorbisFile, -1);
-        std::vector<char> decodedSound;
-        char buffer[4096];
-        for (ssize_t size; (size = ov_read(&vorbisFile, buffer, 4096, 0, 2, 1, nullptr)) != 0;) {
-            if (size < 0) throw std::runtime_error("Failed to decode ogg file");
-            decodedSound.insert(decodedSound.end(), buffer, buffer + size);
-        }
-        alCall(alBufferData, alBuffer, getAlAudioFormat(vorbisInfo->channels, 16), decodedSound.data(),
-               decodedSound.size(), vorbisInfo->rate);
-        ov_clear(&vorbisFile);
-    } else if (extension == ".wav") {
-        unsigned int channel, sampleRate, bps, size;
-        auto buffer = utils::WavReader::loadWAV(audioFile, channel, sampleRate, bps, size);
-        alCall(alBufferData, alBuffer, getAlAudioFormat(channel, bps), buffer.get(), size, sampleRate);
-    } else {
-        throw std::runtime_error("Unsupported audio format (" + extension + ")");
-    }
-
+    alCall(alBufferData, alBuffer, format, samples, size, sampleRate);
     alCall(alSourcei, alSource, AL_BUFFER, alBuffer);
-    audio_[audioFile] = alSource;
-}
-
-void OpenAlAudioPlayer::play(const std::string &audioFile) const noexcept(true) {
-    alCall(alSourcePlay, audio_.at(audioFile));
+    return alSource;
 }
@@ -0,0 +1,195 @@
+#include <thread>
+#include <cstdio>
+#include <climits>
+#include <fstream>
+#include <algorithm>
+#include <sys/stat.h>
+#include <vorbis/vorbisfile.h>
+
+#include "sound/platform/desktop/PcmCache.h"
+
+static constexpr char pcmMagic[4]{'T', 'W', 'P', 'A'};
+static constexpr uint32_t pcmVersion{1};
+static constexpr std::size_t sampleAlignment{8};
+
+/**
+ * The header of a cache entry, the path of the asset follows it padded to the alignment, then the samples
+ */
+struct PcmHeader {
+    char magic[4];
+    uint32_t version;
+    int64_t mtime;          // of the asset in nanoseconds
+    uint64_t size;          // of the asset
+    uint32_t channels;
+    uint32_t sampleRate;
+    uint32_t pathLength;
+    uint32_t reserved;
+    uint64_t sampleBytes;
+};
+
+static std::size_t samplesOffset(std::size_t pathLength) {
+    return (sizeof(PcmHeader) + pathLength + sampleAlignment - 1) / sampleAlignment * sampleAlignment;
+}
+
+std::string_view PcmCache::Sound::samples() const {
+    if (mapping_) return mapping_->view().substr(offset_);
+    return {decoded_.data(), decoded_.size()};
+}
+
+PcmCache::PcmCache(std::filesystem::path directory) : directory_(std::move(directory)) {
+    std::error_code error;
+    if (!directory_.empty()) std::filesystem::create_directories(directory_, error);
+}
+
+PcmCache::Sound PcmCache::load(const std::string &oggFile) {
+    struct stat fileStat{};
+    if (directory_.empty() || stat(oggFile.c_str(), &fileStat) == -1) return decode(oggFile);
+    auto mtime{fileStat.st_mtim.tv_sec * 1000000000ll + fileStat.st_mtim.tv_nsec};
+    auto size{static_cast<uint64_t>(fileStat.st_size)};
+
+    auto entryFile{entry(oggFile)};
+    if (auto cached{read(entryFile, oggFile, mtime, size)}) return std::move(*cached);
+
+    auto sound{decode(oggFile)};
+    write(entryFile, oggFile, mtime, size, sound);
+    return sound;
+}
+
+PcmCache::Sound PcmCache::decode(const std::string &oggFile) {
+    auto dataSource{std::fopen(oggFile.c_str(), "rb")};
+    if (dataSource == nullptr) throw std::runtime_error("Failed to open file: " + oggFile);
+
+    // the vorbis file closes the data source once it's opened
+    OggVorbis_File vorbisFile;
+    if (ov_open_callbacks(dataSource, &vorbisFile, nullptr, 0, OV_CALLBACKS_DEFAULT) < 0) {
+        std::fclose(dataSource);
+        throw std::runtime_error("Failed to open ogg file: " + oggFile);
+    }
+    return decode(vorbisFile, oggFile);
+}
+
+/**
+ * Reads an ogg stream built into the program
+ */
+struct MemorySource {
+    std::string_view bytes;
+    std::size_t position = 0;
+};
+
+static std::size_t readMemory(void *buffer, std::size_t size, std::size_t count, void *dataSource) {
+    auto source{static_cast<MemorySource *>(dataSource)};
+    if (size == 0) return 0;
+    auto items{std::min(count, (source->bytes.size() - source->position) / size)};
+    std::copy_n(source->bytes.data() + source->position, items * size, static_cast<char *>(buffer));
+    source->position += items * size;
+    return items;
+}
+
+static int seekMemory(void *dataSource, ogg_int64_t offset, int whence) {
+    auto source{static_cast<MemorySource *>(dataSource)};
+    auto base{whence == SEEK_SET ? 0 : whence == SEEK_CUR ? static_cast<ogg_int64_t>(source->position)
+                                                          : static_cast<ogg_int64_t>(source->bytes.size())};
+    if (base + offset < 0 || base + offset > static_cast<ogg_int64_t>(source->bytes.size())) return -1;
+    source->position = static_cast<std::size_t>(base + offset);
+    return 0;
+}
+
+static long tellMemory(void *dataSource) {
+    return static_cast<long>(static_cast<MemorySource *>(dataSource)->position);
+}
+
+PcmCache::Sound PcmCache::decodeMemory(std::string_view ogg, const std::string &name) {
+    MemorySource source{ogg};
+    OggVorbis_File vorbisFile;
+    if (ov_open_callbacks(&source, &vorbisFile, nullptr, 0, {readMemory, seekMemory, nullptr, tellMemory}) < 0)
+        throw std::runtime_error("Failed to open ogg stream: " + name);
+    return decode(vorbisFile, name);
+}
+
+PcmCache::Sound PcmCache::decode(OggVorbis_File &vorbisFile, const std::string &name) {
+    auto vorbisInfo{ov_info(&vorbisFile, -1)};
+    Sound sound;
+    sound.channels = static_cast<unsigned int>(vorbisInfo->channels);
+    sound.sampleRate = static_cast<unsigned int>(vorbisInfo->rate);
+
+    // sized for the whole stream up front so the samples are decoded in place, with room for the read that reports
+    // the end, a stream that doesn't know its length grows
+    auto &decoded{sound.decoded_};
+    auto frames{ov_pcm_total(&vorbisFile, -1)};
+    decoded.resize((frames > 0 ? static_cast<std::size_t>(frames) * sound.channels * 2 : 0) + 4096);
+    std::size_t used{0};
+    for (long size;; used += static_cast<std::size_t>(size)) {
+        if (decoded.size() - used < 4096) decoded.resize(decoded.size() * 2);
+        size = ov_read(&vorbisFile, decoded.data() + used,
+                       static_cast<int>(std::min<std::size_t>(decoded.size() - used, INT_MAX)), 0, 2, 1, nullptr);
+        if (size == 0) break;
+        if (size == OV_HOLE) size = 0;  // a gap in the stream, the decoding goes on after it
+        else if (size < 0) {
+            ov_clear(&vorbisFile);
+            throw std::runtime_error("Failed to decode ogg file: " + name);
+        }
+    }
+    decoded.resize(used);
+    ov_clear(&vorbisFile);
+    return sound;
+}
+
+std::filesystem::path PcmCache::entry(const std::string &oggFile) const {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016zx.pcm", std::hash<std::string>{}(oggFile));
+    return directory_ / name;
+}
+
+std::optional<PcmCache::Sound>
+PcmCache::read(const std::filesystem::path &entry, const std::string &oggFile, int64_t mtime, uint64_t size) {
+    std::error_code error;
+    if (!std::filesystem::exists(entry, error)) return std::nullopt;
+
+    auto file{std::make_unique<utils::MappedFile>(entry)};
+    auto content{file->view()};
+
+    PcmHeader header{};
+    if (content.size() < sizeof(header)) return std::nullopt;
+    std::copy_n(content.data(), sizeof(header), reinterpret_cast<char *>(&header));
+    // the path tells apart two assets whose paths hash the same
+    if (!std::equal(std::begin(pcmMagic), std::end(pcmMagic), header.magic) || header.version != pcmVersion ||
+        header.mtime != mtime || header.size != size || header.pathLength != oggFile.size() ||
+        content.substr(sizeof(header), header.pathLength) != oggFile ||
+        content.size() != samplesOffset(header.pathLength) + header.sampleBytes)
+        return std::nullopt;
+
+    Sound sound;
+    sound.channels = header.channels;
+    sound.sampleRate = header.sampleRate;
+    sound.offset_ = samplesOffset(header.pathLength);
+    sound.mapping_ = std::move(file);
+    return sound;
+}
+
+void PcmCache::write(const std::filesystem::path &entry, const std::string &oggFile, int64_t mtime, uint64_t size,
+                     const Sound &sound) {
+    auto samples{sound.samples()};
+    PcmHeader header{{}, pcmVersion, mtime, size, sound.channels, sound.sampleRate,
+                     static_cast<uint32_t>(oggFile.size()), 0, samples.size()};
+    std::copy(std::begin(pcmMagic), std::end(pcmMagic), header.magic);
+
+    // written next to the entry and renamed over it, so a concurrent load never maps half of it
+    auto temporary{entry};
+    temporary += ".tmp" + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+        std::ofstream file(temporary, std::ios::binary | std::ios::trunc);
+        if (!file) return;     // the cache is only an optimization
+
+        char padding[sampleAlignment]{};
+        file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        file.write(oggFile.data(), static_cast<std::streamsize>(oggFile.size()));
+        file.write(padding, static_cast<std::streamsize>(samplesOffset(oggFile.size()) - sizeof(header) -
+                                                         oggFile.size()));
+        file.write(samples.data(), static_cast<std::streamsize>(samples.size()));
+        if (!file) return;
+    }
+
+    std::error_code error;
+    std::filesystem::rename(temporary, entry, error);
+    if (error) std::filesystem::remove(temporary, error);
+}
@@ -1,81 +1,315 @@
 #include <thread>
+#include <cstring>
 #include <fcntl.h>
 #include <unistd.h>
 #include <iostream>
+#include <poll.h>
+#include <spawn.h>
+#include <csignal>
+#include <algorithm>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include <sys/wait.h>
-#include <codecvt>
-#include <locale>
+#include <sys/syscall.h>
+#include <linux/futex.h>
 
 #include "utils.h"
+#include "config.h"
+#include "TextWidth.h"
 
-utils::ProcessResult
-utils::executeProcess(const std::string &path, const std::vector<const char *> &args) noexcept(false) {
+static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t) && std::atomic<uint32_t>::is_always_lock_free,
+              "the futex is the word of the atomic itself");
+
+void utils::concurrent::detail::waitFor(const std::atomic<uint32_t> &word, uint32_t old,
+                                        std::chrono::nanoseconds timeout) {
+    auto seconds{std::chrono::duration_cast<std::chrono::seconds>(timeout)};
+    timespec relative{static_cast<time_t>(seconds.count()), static_cast<long>((timeout - seconds).count())};
+    syscall(SYS_futex, reinterpret_cast<const uint32_t *>(&word), FUTEX_WAIT_PRIVATE, old, &relative, nullptr, 0);
+}
+
+void utils::concurrent::detail::wakeAll(const std::atomic<uint32_t> &word) {
+    syscall(SYS_futex, reinterpret_cast<const uint32_t *>(&word), FUTEX_WAKE_PRIVATE, INT32_MAX, nullptr, nullptr, 0);
+}
+
+/**
+ * Opens a file descriptor that becomes readable when the process exits
+ * @return the pidfd or -1 if the kernel doesn't support it
+ */
+static int openPidFd(pid_t pid) {
+#ifdef SYS_pidfd_open
+    return static_cast<int>(syscall(SYS_pidfd_open, pid, 0));
+#else
+    return -1;
+#endif
+}
+
+/**
+ * Spawns a process with stdout and stderr redirected to a pipe
+ * @param outputFd set to the read end of the pipe
+ * @return the pid of the process
+ */
+static pid_t spawnProcess(const std::string &path, const std::vector<const char *> &args, int &outputFd) {
     int fields[2];  // 0: read fd, 1: write fd
-    char buf[256]{0};
+
+    // argv[0] is the program itself, the given args follow it
+    std::vector<char *> argv{const_cast<char *>(path.c_str())};
+    for (auto arg: args) argv.push_back(const_cast<char *>(arg));
+    if (argv.back() != nullptr) argv.push_back(nullptr);
+
+    // O_CLOEXEC keeps the pipe from leaking into children spawned concurrently by other threads
+    if (pipe2(fields, O_CLOEXEC) == -1) throw std::runtime_error("Failed to create pipe");
+
+    // the child is redirected by file actions instead of fork(), which would copy the page tables of the whole
+    // process (ncurses and the audio mixer) only to replace them with execv()
+    posix_spawn_file_actions_t fileActions;
+    posix_spawn_file_actions_init(&fileActions);
+    posix_spawn_file_actions_addopen(&fileActions, STDIN_FILENO, "/dev/null", O_RDONLY, 0);
+    posix_spawn_file_actions_adddup2(&fileActions, fields[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&fileActions, fields[1], STDERR_FILENO);
+
+    // the signals the event loop reads from a signalfd are blocked, the child gets an empty mask back
+    posix_spawnattr_t attributes;
+    posix_spawnattr_init(&attributes);
+    sigset_t signals;
+    sigemptyset(&signals);
+    posix_spawnattr_setsigmask(&attributes, &signals);
+    posix_spawnattr_setflags(&attributes, POSIX_SPAWN_SETSIGMASK);
+
+    pid_t pid;
+    auto spawnError{posix_spawn(&pid, path.c_str(), &fileActions, &attributes, argv.data(), environ)};
+    posix_spawnattr_destroy(&attributes);
+    posix_spawn_file_actions_destroy(&fileActions);
+    close(fields[1]);
+
+    if (spawnError != 0) {
+        close(fields[0]);
+        throw std::runtime_error("Failed to exec: " + path);
+    }
+
+    outputFd = fields[0];
+    return pid;
+}
+
+/**
+ * Spawns a process and drains its output until it exits
+ * @param output the output is read straight into it if set, it's grown geometrically
+ * @param sink the output is passed to it chunk by chunk if set, so it's never held in memory as a whole
+ * @return the wait status of the process
+ */
+static int runProcess(const std::string &path, const std::vector<const char *> &args,
+                      std::chrono::milliseconds timeout, std::string *output,
+                      const std::function<void(std::string_view)> *sink) {
+    int outputFd;
     auto status{0};
-    std::string output;
+    auto pid{spawnProcess(path, args, outputFd)};
+
+    // drain the pipe while the child runs, waiting for the child before reading would deadlock as soon as its
+    // output is bigger than the pipe buffer
+    auto deadline{std::chrono::steady_clock::now() + timeout};
+    auto pidFd{openPidFd(pid)};
+    std::size_t size{0};
+    bool outputOpen{true}, exited{false};
+    char chunk[64 * 1024];
+
+    auto abort = [&] {
+        kill(pid, SIGKILL);
+        waitpid(pid, &status, 0);
+        if (pidFd != -1) close(pidFd);
+        close(outputFd);
+    };
+
+    while (outputOpen || !exited) {
+        auto remaining{std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now())};
+        if (remaining.count() <= 0) {
+            abort();
+            throw std::runtime_error("Timed out: " + path);
+        }
+
+        // without a pidfd the exit can only be noticed by polling waitpid once the output is closed
+        if (pidFd == -1 && !outputOpen) remaining = std::min(remaining, std::chrono::milliseconds(10));
+
+        pollfd fds[2]{{outputOpen ? outputFd : -1, POLLIN, 0},
+                      {exited ? -1 : pidFd,         POLLIN, 0}};
+        if (poll(fds, 2, static_cast<int>(remaining.count())) == -1) {
+            if (errno == EINTR) continue;
+            abort();
+            throw std::runtime_error("Failed to poll: " + path);
+        }
 
-    if (pipe(fields) == -1) throw std::runtime_error("Failed to create pipe");
-    auto pid{fork()};
-
-    switch (pid) {
-        case -1:
-            throw std::runtime_error("Failed to fork");
-        case 0:
-            close(fields[0]);
-            dup2(open("/dev/null", O_RDONLY), STDIN_FILENO);
-            dup2(fields[1], STDOUT_FILENO);
-            dup2(fields[1], STDERR_FILENO);
-            execv(path.c_str(), (char *const *) (args.begin().base()));     // shouldn't return
-            close(fields[1]);
-            _exit(-1);          // to terminate all threads
-        default:
-            close(fields[1]);
-            waitpid(pid, &status, 0);
-            while (read(fields[0], buf, sizeof(buf)) > 0) { output.append(buf); }
-            close(fields[0]);
-
-            if (WEXITSTATUS(status) == 127) throw std::runtime_error("Failed to exec: " + path);
-            break;
+        if (fds[0].revents != 0) {
+            ssize_t count;
+            if (sink != nullptr) {
+                count = read(outputFd, chunk, sizeof(chunk));
+            } else {
+                if (size == output->size()) output->resize(std::max<std::size_t>(4096, size * 2));
+                count = read(outputFd, output->data() + size, output->size() - size);
+            }
+
+            if (count > 0) {
+                size += count;
+                if (sink != nullptr) {
+                    try {
+                        (*sink)(std::string_view(chunk, count));
+                    } catch (...) {
+                        abort();
+                        throw;
+                    }
+                }
+            } else if (count == 0 || errno != EINTR) {
+                outputOpen = false;
+            }
+        }
+
+        if (!exited && (pidFd == -1 ? !outputOpen : fds[1].revents != 0))
+            exited = waitpid(pid, &status, pidFd == -1 ? WNOHANG : 0) == pid;
     }
+
+    if (pidFd != -1) close(pidFd);
+    close(outputFd);
+
+    if (WEXITSTATUS(status) == 127) throw std::runtime_error("Failed to exec: " + path);
+    if (output != nullptr) output->resize(size);
+    return status;
+}
+
+utils::ProcessResult
+utils::executeProcess(const std::string &path, const std::vector<const char *> &args,
+                      std::chrono::milliseconds timeout) noexcept(false) {
+    std::string output;
+    auto status{runProcess(path, args, timeout, &output, nullptr)};
     output.append(1, '\n');                                     // make sure we have a line end
     return {static_cast<uint8_t>(WEXITSTATUS(status)), output}; // get one line from output
 }
 
-std::string utils::formatDescription(const std::string &description) {
-    std::string newDescription;
-    for (auto it{description.begin() + 9}; it < description.end(); ++it) { // skip "Tracking " word
-        if (*it == '\n')
-            break;
-        else if (*it != '\\')
-            newDescription.append(1, *it);
+utils::ProcessResult
+utils::executeProcess(const std::string &path, const std::vector<const char *> &args,
+                      const std::function<void(std::string_view)> &sink,
+                      std::chrono::milliseconds timeout) noexcept(false) {
+    auto status{runProcess(path, args, timeout, nullptr, &sink)};
+    return {static_cast<uint8_t>(WEXITSTATUS(status)), {}};
+}
+
+utils::ChildProcess::ChildProcess(const std::string &path, const std::vector<const char *> &args) {
+    pid_ = spawnProcess(path, args, outputFd_);
+    fcntl(outputFd_, F_SETFL, fcntl(outputFd_, F_GETFL) | O_NONBLOCK);
+    pidFd_ = openPidFd(pid_);
+}
+
+utils::ChildProcess::~ChildProcess() {
+    kill();
+    if (pidFd_ != -1) close(pidFd_);
+    close(outputFd_);
+}
+
+int utils::ChildProcess::outputFd() const {
+    return outputFd_;
+}
+
+int utils::ChildProcess::pidFd() const {
+    return pidFd_;
+}
+
+bool utils::ChildProcess::read(std::string &output) {
+    char chunk[64 * 1024];
+    while (true) {
+        auto count{::read(outputFd_, chunk, sizeof(chunk))};
+        if (count > 0) {
+            output.append(chunk, count);
+        } else if (count == -1 && errno == EINTR) {
+            continue;
+        } else {
+            return count == -1 && errno == EAGAIN;
+        }
+    }
+}
+
+int utils::ChildProcess::wait() {
+    while (!reaped_) {
+        if (waitpid(pid_, &status_, 0) == pid_ || errno != EINTR) reaped_ = true;
+    }
+    return status_;
+}
+
+void utils::ChildProcess::kill() {
+    if (reaped_) return;
+    ::kill(pid_, SIGKILL);
+    wait();
+}
+
+utils::MappedFile::MappedFile(const std::string &path) {
+    auto fd{open(path.c_str(), O_RDONLY | O_CLOEXEC)};
+    if (fd == -1) throw std::runtime_error("Failed to open file: " + path);
+
+    struct stat fileStat{};
+    if (fstat(fd, &fileStat) == -1) {
+        close(fd);
+        throw std::runtime_error("Failed to stat file: " + path);
     }
-    return newDescription;
+
+    size_ = static_cast<std::size_t>(fileStat.st_size);
+    if (size_ != 0) {
+        data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data_ == MAP_FAILED) {
+            data_ = nullptr;
+            close(fd);
+            throw std::runtime_error("Failed to map file: " + path);
+        }
+    }
+    close(fd);      // the mapping keeps its own reference to the file
+}
+
+utils::MappedFile::~MappedFile() {
+    if (data_ != nullptr) munmap(data_, size_);
+}
+
+std::string_view utils::MappedFile::view() const {
+    return {static_cast<const char *>(data_), data_ == nullptr ? 0 : size_};
+}
+
+std::filesystem::path utils::cacheDirectory() {
+    std::filesystem::path directory;
+    if (auto xdgCacheHome{std::getenv("XDG_CACHE_HOME")}; xdgCacheHome != nullptr && *xdgCacheHome != '\0')
+        directory = std::filesystem::path(xdgCacheHome) / PROJECT_NAME;
+    else if (auto home{std::getenv("HOME")}; home != nullptr)
+        directory = std::filesystem::path(home) / ".cache" / PROJECT_NAME;
+    else
+        return {};
+
+    std::error_code error;
+    std::filesystem::create_directories(directory, error);
+    return error ? std::filesystem::path{} : directory;
 }
 
 std::wstring utils::stringToUtf(const std::string &string) {
-    typedef std::codecvt_utf8<wchar_t> convert_type;
-    std::wstring_convert<convert_type, wchar_t> converter;
-    return converter.from_bytes(string);
+    std::wstring wstring;
+    wstring.reserve(string.size());
+    for (std::size_t pos{0}; pos < string.size();) wstring.push_back(static_cast<wchar_t>(text::decode(string, pos)));
+    return wstring;
 }
 
 std::string utils::utfToString(const std::wstring &wstring) {
-    typedef std::codecvt_utf8<wchar_t> convert_type;
-    std::wstring_convert<convert_type, wchar_t> converter;
-    return converter.to_bytes(wstring);
-}
-
-std::unique_ptr<char>
-utils::WavReader::loadWAV(const std::string &audioFile, unsigned int &chan, unsigned int &sampleRate, unsigned int &bps,
-                          unsigned int &size) {
-    auto file = std::unique_ptr<FILE, decltype(&std::fclose)>(std::fopen(audioFile.c_str(), "r"), std::fclose);
-    struct WavHeader wavHeader{};
-    std::fread(&wavHeader, 1, sizeof(wavHeader), file.get());
-    chan = wavHeader.numOfChan;
-    sampleRate = wavHeader.samplesPerSec;
-    bps = wavHeader.bitsPerSample;
-    size = wavHeader.subChunk2Size;
-    auto buffer = std::unique_ptr<char>(new char[size]);
-    std::fread(buffer.get(), sizeof(char), size, file.get());
-    return buffer;
+    std::string string;
+    string.reserve(wstring.size());
+    for (auto wc: wstring) {
+        auto c{static_cast<char32_t>(wc)};
+        if ((c >= 0xD800 && c <= 0xDFFF) || c > 0x10FFFF) c = text::replacementCharacter;
+
+        if (c < 0x80) {
+            string.push_back(static_cast<char>(c));
+        } else if (c < 0x800) {
+            string.push_back(static_cast<char>(0xC0 | c >> 6));
+            string.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+        } else if (c < 0x10000) {
+            string.push_back(static_cast<char>(0xE0 | c >> 12));
+            string.push_back(static_cast<char>(0x80 | (c >> 6 & 0x3F)));
+            string.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+        } else {
+            string.push_back(static_cast<char>(0xF0 | c >> 18));
+            string.push_back(static_cast<char>(0x80 | (c >> 12 & 0x3F)));
+            string.push_back(static_cast<char>(0x80 | (c >> 6 & 0x3F)));
+            string.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+        }
+    }
+    return string;
 }
+
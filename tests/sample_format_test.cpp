@@ -0,0 +1,104 @@
+#include <limits>
+#include <string>
+#include <vector>
+#include <utility>
+#include <cstring>
+#include <iostream>
+
+#include "SampleFormat.h"
+
+using utils::pcm::Encoding;
+
+static int failures{0};
+
+/**
+ * A sample as stored in the file and the signed 16 bits sample it converts to
+ */
+struct Case {
+    std::string bytes;
+    int16_t expected;
+};
+
+static std::string bytes(std::initializer_list<unsigned char> values) {
+    return {values.begin(), values.end()};
+}
+
+static std::string floatBytes(float value) {
+    std::string stored(sizeof(value), '\0');
+    std::memcpy(stored.data(), &value, sizeof(value));
+    return stored;
+}
+
+/**
+ * Converts the cases repeated past the width of the vector kernels, so that both the kernels and the scalar tail
+ * go through every case
+ */
+static void check(const char *name, Encoding encoding, const std::vector<Case> &cases) {
+    constexpr std::size_t count{67};
+    std::string samples;
+    std::vector<int16_t> expected;
+    for (auto i{0u}; i < count; ++i) {
+        samples.append(cases[i % cases.size()].bytes);
+        expected.push_back(cases[i % cases.size()].expected);
+    }
+
+    typedef void (*Convert)(Encoding, std::string_view, int16_t *);
+    const std::pair<Convert, const char *> conversions[]{{utils::pcm::toSigned16, "vector"},
+                                                         {utils::pcm::toSigned16Scalar, "scalar"}};
+    for (const auto &[function, kind]: conversions) {
+        std::vector<int16_t> out(count);
+        function(encoding, samples, out.data());
+        for (auto i{0u}; i < count; ++i) {
+            if (out[i] == expected[i]) continue;
+            std::cerr << name << " (" << kind << "): sample " << i << " is " << out[i] << ", expected "
+                      << expected[i] << '\n';
+            ++failures;
+            break;
+        }
+    }
+}
+
+/**
+ * Checks the conversion of every encoding against known values
+ */
+auto main() -> int {
+    // (u - 128) * 256
+    check("8 bits", Encoding::UNSIGNED_8, {{bytes({0x00}), -32768}, {bytes({0x01}), -32512}, {bytes({0x7F}), -256},
+                                           {bytes({0x80}), 0}, {bytes({0x81}), 256}, {bytes({0xFF}), 32512}});
+
+    check("16 bits", Encoding::SIGNED_16, {{bytes({0x34, 0x12}), 0x1234}, {bytes({0xFF, 0x7F}), 32767},
+                                           {bytes({0x00, 0x80}), -32768}, {bytes({0xFF, 0xFF}), -1}});
+
+    // the two high bytes, the low one is dropped
+    check("24 bits", Encoding::SIGNED_24, {{bytes({0x56, 0x34, 0x12}), 0x1234}, {bytes({0xFF, 0xFF, 0x7F}), 32767},
+                                           {bytes({0x00, 0x00, 0x80}), -32768}, {bytes({0xFF, 0xFF, 0xFF}), -1},
+                                           {bytes({0xFF, 0x00, 0x00}), 0}});
+
+    // shifted right by 16, truncated toward negative infinity
+    check("32 bits", Encoding::SIGNED_32, {{bytes({0x78, 0x56, 0x34, 0x12}), 0x1234},
+                                           {bytes({0xFF, 0xFF, 0xFF, 0x7F}), 32767},
+                                           {bytes({0x00, 0x00, 0x00, 0x80}), -32768},
+                                           {bytes({0xFF, 0xFF, 0xFF, 0xFF}), -1},
+                                           {bytes({0xFF, 0xFF, 0x00, 0x00}), 0}});
+
+    // scaled by 32768, rounded to the nearest even and clipped, a NaN clips to the top
+    check("float", Encoding::FLOAT_32, {{floatBytes(0.0f), 0}, {floatBytes(0.5f), 16384},
+                                        {floatBytes(-0.5f), -16384}, {floatBytes(1.5f / 32768), 2},
+                                        {floatBytes(2.5f / 32768), 2}, {floatBytes(-1.5f / 32768), -2},
+                                        {floatBytes(0.6f / 32768), 1}, {floatBytes(1.0f), 32767},
+                                        {floatBytes(-1.0f), -32768}, {floatBytes(1.5f), 32767},
+                                        {floatBytes(-1.5f), -32768},
+                                        {floatBytes(std::numeric_limits<float>::infinity()), 32767},
+                                        {floatBytes(-std::numeric_limits<float>::infinity()), -32768},
+                                        {floatBytes(std::numeric_limits<float>::quiet_NaN()), 32767}});
+
+    // a trailing partial sample is ignored
+    int16_t out[2]{7, 7};
+    utils::pcm::toSigned16(Encoding::SIGNED_24, bytes({0x00, 0x00, 0x40, 0x00, 0x00}), out);
+    if (out[0] != 0x4000 || out[1] != 7) {
+        std::cerr << "24 bits: a partial sample was converted\n";
+        ++failures;
+    }
+
+    return failures == 0 ? 0 : 1;
+}
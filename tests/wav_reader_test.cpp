@@ -0,0 +1,94 @@
+#include <string>
+#include <cstring>
+#include <iostream>
+#include <stdexcept>
+#include <filesystem>
+
+#include "utils.h"
+#include "WavReader.h"
+
+using utils::pcm::Encoding;
+
+static int failures{0};
+
+static void expect(bool condition, const std::string &what) {
+    if (condition) return;
+    std::cerr << what << '\n';
+    ++failures;
+}
+
+/**
+ * What a seed of the corpus parses to
+ */
+struct Seed {
+    const char *file;
+    Encoding encoding;
+    unsigned int channels;
+    unsigned int sampleRate;
+    std::size_t offset;         // of the samples in the file
+    std::size_t size;           // of the samples in bytes
+    int16_t firstSample;        // once loaded
+};
+
+/**
+ * Parses and loads the seeds of the wav fuzzer
+ * usage: wav-reader-test <corpus directory>
+ */
+auto main(int argc, char *argv[]) -> int {
+    if (argc != 2) {
+        std::cerr << "usage: wav-reader-test <corpus directory>\n";
+        return 2;
+    }
+    std::filesystem::path corpus{argv[1]};
+
+    const Seed seeds[]{
+            {"u8-mono.wav",               Encoding::UNSIGNED_8, 1, 8000, 44, 40, -24064},
+            {"s16-stereo.wav",            Encoding::SIGNED_16,  2, 8000, 44, 64, -23034},
+            // a LIST chunk of odd size and its padding before the samples
+            {"s24-stereo-list.wav",       Encoding::SIGNED_24,  2, 8000, 58, 96, -10113},
+            // the data chunk claims 72 bytes, 66 are there and the partial sample is dropped
+            {"s32-mono-truncated.wav",    Encoding::SIGNED_32,  1, 8000, 44, 64, 24030},
+            // WAVE_FORMAT_EXTENSIBLE with the float sub format
+            {"f32-stereo-extensible.wav", Encoding::FLOAT_32,   2, 8000, 68, 80, 20800}};
+
+    for (const auto &seed: seeds) {
+        std::string name{seed.file};
+        try {
+            utils::MappedFile file(corpus / seed.file);
+            auto riff{file.view()};
+            auto format{WavReader::parse(riff)};
+            expect(format.encoding == seed.encoding, name + ": wrong encoding");
+            expect(format.channels == seed.channels, name + ": " + std::to_string(format.channels) + " channels");
+            expect(format.sampleRate == seed.sampleRate, name + ": " + std::to_string(format.sampleRate) + "Hz");
+            expect(format.samples.data() == riff.data() + seed.offset,
+                   name + ": samples at " + std::to_string(format.samples.data() - riff.data()));
+            expect(format.samples.size() == seed.size,
+                   name + ": " + std::to_string(format.samples.size()) + " bytes of samples");
+
+            auto sound{WavReader::load((corpus / seed.file).string())};
+            auto samples{sound.samples()};
+            expect(sound.channels == seed.channels && sound.sampleRate == seed.sampleRate, name + ": loaded format");
+            expect(samples.size() == seed.size / utils::pcm::sampleBytes(seed.encoding) * sizeof(int16_t),
+                   name + ": " + std::to_string(samples.size()) + " bytes loaded");
+            int16_t first{0};
+            if (samples.size() >= sizeof(first)) std::memcpy(&first, samples.data(), sizeof(first));
+            expect(first == seed.firstSample, name + ": first sample is " + std::to_string(first));
+        } catch (const std::runtime_error &error) {
+            expect(false, name + ": " + error.what());
+        }
+    }
+
+    // what isn't a supported wav file is rejected
+    for (auto riff: {std::string_view("RIFF\0\0\0\0WAVE", 12), std::string_view("RIFF\0\0\0\0AVI ", 12),
+                     std::string_view("RIFF")}) {
+        auto threw{false};
+        try {
+            WavReader::parse(riff);
+        } catch (const std::runtime_error &) {
+            threw = true;
+        }
+        expect(threw, "a malformed file was parsed");
+    }
+
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,69 @@
+#include <cstdio>
+#include <string>
+#include <unistd.h>
+#include <stdexcept>
+#include <string_view>
+
+#include "ControlSocket.h"
+
+static constexpr std::string_view usage{
+        "usage: tw-pomodoro-ctl start|continue|pause|status|quit\n"
+        "       tw-pomodoro-ctl hook    (the taskwarrior on-modify hook, also when named on-modify.*)\n"};
+
+/**
+ * Checks whether a task in JSON has a start, the quotes inside strings are escaped so an unescaped "start": is a key
+ */
+static bool hasStart(std::string_view task) {
+    for (auto pos{task.find("\"start\":")}; pos != std::string_view::npos; pos = task.find("\"start\":", pos + 1)) {
+        if (pos == 0 || task[pos - 1] != '\\') return true;
+    }
+    return false;
+}
+
+/**
+ * Passes the modified task through and starts a session when the task was started, taskwarrior rejects the
+ * modification if a hook fails so every error is ignored
+ */
+static int hook() {
+    std::string input;
+    char buffer[4096];
+    ssize_t size;
+    while ((size = read(STDIN_FILENO, buffer, sizeof(buffer))) > 0) input.append(buffer, size);
+
+    std::string_view lines{input};
+    auto oldTask{lines.substr(0, lines.find('\n'))};
+    lines.remove_prefix(std::min(lines.size(), oldTask.size() + 1));
+    auto newTask{lines.substr(0, lines.find('\n'))};
+
+    std::fwrite(newTask.data(), 1, newTask.size(), stdout);
+    std::fputc('\n', stdout);
+    std::fflush(stdout);
+
+    if (hasStart(newTask) && !hasStart(oldTask)) {
+        try {
+            ControlSocket::send(ControlSocket::defaultPath(), "start", std::chrono::milliseconds(0));
+        } catch (const std::runtime_error &) {}     // no tw-pomodoro is running
+    }
+    return 0;
+}
+
+auto main(int argc, char *argv[]) -> int {
+    std::string_view name{argv[0]};
+    name.remove_prefix(name.find_last_of('/') + 1);
+    std::string_view command{argc > 1 ? argv[1] : ""};
+    // taskwarrior passes its own arguments to hooks
+    if (name.starts_with("on-modify") || command == "hook") return hook();
+
+    if (argc != 2 || !ControlSocket::parse(command)) {
+        std::fwrite(usage.data(), 1, usage.size(), stderr);
+        return 2;
+    }
+    try {
+        auto reply{ControlSocket::send(ControlSocket::defaultPath(), command, std::chrono::seconds(1)) + '\n'};
+        std::fwrite(reply.data(), 1, reply.size(), stdout);
+        return reply.starts_with("error:") ? 1 : 0;
+    } catch (const std::runtime_error &error) {
+        std::fprintf(stderr, "%s\n", error.what());
+        return 1;
+    }
+}
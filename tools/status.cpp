@@ -0,0 +1,28 @@
+#include <cstdio>
+#include <string_view>
+
+#include "StatusSegment.h"
+
+static constexpr std::string_view usage{
+        "usage: tw-pomodoro-status [format]\n"
+        "prints the state of the running session, the format expands\n"
+        "  %s  focus, break, paused or idle\n"
+        "  %r  the time left, [H:]MM:SS\n"
+        "  %t  the task description\n"
+        "  %%  a literal %\n"
+        "nothing is printed and the exit status is 1 if no tw-pomodoro is running\n"};
+
+auto main(int argc, char *argv[]) -> int {
+    std::string_view lineFormat{argc > 1 ? argv[1] : ""};
+    if (argc > 2 || lineFormat == "-h" || lineFormat == "--help") {
+        std::fwrite(usage.data(), 1, usage.size(), stderr);
+        return 2;
+    }
+
+    auto status{StatusSegment::read()};
+    if (!status) return 1;
+
+    auto line{StatusSegment::format(*status, lineFormat) + '\n'};
+    std::fwrite(line.data(), 1, line.size(), stdout);
+    return 0;
+}